@@ -48,8 +48,9 @@ AD5674RClass myDAC_R(CS_PIN_R, LDAC_PIN_R, RESET_PIN_R);
 void setup(){
 	// Power up/down example:
 	// Power down half of the channels of the AD5674R
+	uint8_t channels[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
 	bool power_up[16] = {1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0};
-	myDAC_R.powerUpDown(power_up, 16);
+	myDAC_R.powerUpDown(channels, power_up, 16);
 
 	// Channel setting example with float values:
 	// Set the powered-up channels of the AD5674R to increasing voltages between 0 and 1.8V, using the internal reference
@@ -79,11 +80,13 @@ void loop(){
 		}
 	}
 	else{
-		sawtooth_value -= 100;
-		if(sawtooth_value <= 0){
+		if(sawtooth_value <= 100){ // word is unsigned, check before subtracting
 			direction = true;
 			sawtooth_value = 0;
 		}
+		else{
+			sawtooth_value -= 100;
+		}
 	}
 
 	delay(10);
@@ -0,0 +1,429 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+AD567XSim.cpp - Behavioural model of the AD5674(R)/AD5679(R) 16-channel DACs for host-side builds.
+*/
+
+#include "AD567XSim.h"
+
+static AD567XSim *sim_devices[32];
+static uint8_t sim_num_devices = 0;
+static AD567XSimBusCounters sim_bus = {0, 0, 0, 0, 0};
+static uint32_t sim_clock = 4000000;
+
+// Bit-banged bus, and the byte being shifted on it
+static pin_size_t sim_SCLK_pin = 0xFF;
+static pin_size_t sim_MOSI_pin = 0xFF;
+static pin_size_t sim_MISO_pin = 0xFF;
+static uint8_t sim_bit_count = 0;
+static uint8_t sim_bits_in = 0;
+static uint8_t sim_bits_out = 0;
+
+AD567XSim::AD567XSim(uint8_t resolution, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin)
+{
+	_resolution = resolution;
+	_CS_pin = CS_pin;
+	_LDAC_pin = LDAC_pin;
+	_RESET_pin = RESET_pin;
+	_ldac_low = false;
+	_shift = 0;
+	_bits = 0;
+	_latched = false;
+	reset();
+	clearCounters();
+
+	// Append to the daisy chain of devices sharing the same SYNC line
+	for (uint8_t i = 0; i < sim_num_devices; i++)
+	{
+		if (sim_devices[i]->_CS_pin == CS_pin && sim_devices[i]->_next == nullptr)
+		{
+			sim_devices[i]->_next = this;
+		}
+	}
+	if (sim_num_devices < sizeof(sim_devices) / sizeof(sim_devices[0]))
+	{
+		sim_devices[sim_num_devices++] = this;
+	}
+}
+
+AD567XSim::~AD567XSim()
+{
+	for (uint8_t i = 0; i < sim_num_devices; i++)
+	{
+		if (sim_devices[i]->_next == this)
+		{
+			sim_devices[i]->_next = _next;
+		}
+	}
+	for (uint8_t i = 0; i < sim_num_devices; i++)
+	{
+		if (sim_devices[i] == this)
+		{
+			for (uint8_t j = i + 1; j < sim_num_devices; j++)
+			{
+				sim_devices[j - 1] = sim_devices[j];
+			}
+			sim_num_devices--;
+			break;
+		}
+	}
+}
+
+void AD567XSim::reset()
+{
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		_input[i] = 0;
+		_dac[i] = 0;
+		_power[i] = 0;
+	}
+	_internal_ref = true;
+	_ldac_mask = 0;
+	_daisy_chain = false;
+	_readback = -1;
+}
+
+uint32_t AD567XSim::frames() const
+{
+	uint32_t total = 0;
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		total += _frames[i];
+	}
+	return total;
+}
+
+void AD567XSim::clearCounters()
+{
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		_frames[i] = 0;
+	}
+	_incomplete = 0;
+	_ldac_pulses = 0;
+}
+
+AD567XSimBusCounters &AD567XSim::bus()
+{
+	return sim_bus;
+}
+
+void AD567XSim::clearBusCounters()
+{
+	sim_bus = {0, 0, 0, 0, 0};
+}
+
+word AD567XSim::registerWord(word data) const
+{
+	return _resolution == 12 ? (data & 0xFFF0) : data;
+}
+
+void AD567XSim::loadDAC(word mask)
+{
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		if (mask & (1 << i))
+		{
+			_dac[i] = _input[i];
+		}
+	}
+}
+
+void AD567XSim::execute(uint32_t frame)
+{
+	uint8_t command = (frame >> 20) & 0x0F;
+	uint8_t address = (frame >> 16) & 0x0F;
+	word data = frame & 0xFFFF;
+
+	_frames[command]++;
+
+	switch (command)
+	{
+	case 0x1: // Write to Input Register n
+		_input[address] = registerWord(data);
+		if (_ldac_low)
+		{
+			loadDAC(~_ldac_mask & (1 << address));
+		}
+		break;
+	case 0x2: // Update DAC Register n with Input Register n
+		loadDAC(data);
+		break;
+	case 0x3: // Write to and update DAC Register n
+		_input[address] = registerWord(data);
+		_dac[address] = _input[address];
+		break;
+	case 0x4: // Power up/down, two bits per channel
+	{
+		uint8_t first = (address & 0x08) ? 8 : 0;
+		for (uint8_t i = 0; i < 8; i++)
+		{
+			_power[first + i] = (data >> (2 * i)) & 0x03;
+		}
+		break;
+	}
+	case 0x5: // LDAC mask register
+		_ldac_mask = data;
+		break;
+	case 0x6: // Software reset
+		if (data == 0x1234)
+		{
+			reset();
+		}
+		break;
+	case 0x7: // Reference setup
+		_internal_ref = !(data & 0x0001);
+		break;
+	case 0x8: // Daisy-chain enable
+		_daisy_chain = data & 0x0001;
+		break;
+	case 0x9: // Readback, clocked out during the next frame
+		_readback = address;
+		break;
+	case 0xA: // Write to all input registers
+		for (uint8_t i = 0; i < 16; i++)
+		{
+			_input[i] = registerWord(data);
+		}
+		if (_ldac_low)
+		{
+			loadDAC(~_ldac_mask);
+		}
+		break;
+	case 0xB: // Write to all input and DAC registers
+		for (uint8_t i = 0; i < 16; i++)
+		{
+			_input[i] = registerWord(data);
+			_dac[i] = _input[i];
+		}
+		break;
+	default: // No operation / reserved
+		break;
+	}
+}
+
+uint8_t AD567XSim::shiftByte(uint8_t data)
+{
+	uint8_t out = (_shift >> 16) & 0xFF;
+	_shift = ((_shift << 8) | data) & 0xFFFFFF;
+	_bits += 8;
+
+	// In standalone mode the frame is executed on the 24th SCLK edge, further bits are ignored
+	if (!_daisy_chain && !_latched && _bits >= 24)
+	{
+		_latched = true;
+		execute(_shift);
+	}
+	return out;
+}
+
+void AD567XSim::syncRising()
+{
+	if (_daisy_chain && !_latched)
+	{
+		// In daisy-chain mode the last 24 bits are executed on the rising edge of SYNC
+		// (unless the frame enabling it already ran on the 24th edge)
+		if (_bits >= 24)
+		{
+			execute(_shift);
+		}
+		else if (_bits)
+		{
+			_incomplete++;
+		}
+	}
+	else if (_bits && !_latched)
+	{
+		_incomplete++;
+	}
+
+	if (_readback >= 0)
+	{
+		_shift = _dac[_readback];
+		_readback = -1;
+	}
+	_bits = 0;
+	_latched = false;
+}
+
+void AD567XSim::onPinWrite(pin_size_t pin, uint8_t old_value, uint8_t value)
+{
+	if (old_value == value)
+	{
+		return;
+	}
+
+	if (pin == sim_SCLK_pin)
+	{
+		if (value == LOW)
+		{
+			onSCLKFalling();
+		}
+		return;
+	}
+
+	bool cs_edge = false;
+	bool ldac_edge = false;
+	for (uint8_t i = 0; i < sim_num_devices; i++)
+	{
+		AD567XSim *dev = sim_devices[i];
+		if (dev->_CS_pin == pin)
+		{
+			cs_edge = true;
+			if (value == HIGH)
+			{
+				dev->syncRising();
+			}
+			else
+			{
+				dev->_bits = 0;
+				dev->_latched = false;
+			}
+		}
+		if (dev->_LDAC_pin == pin)
+		{
+			ldac_edge = true;
+			dev->_ldac_low = (value == LOW);
+			if (value == LOW)
+			{
+				dev->_ldac_pulses++;
+				dev->loadDAC(~dev->_ldac_mask);
+			}
+		}
+		if (dev->_RESET_pin == pin && value == LOW)
+		{
+			dev->reset();
+		}
+	}
+	if (cs_edge)
+	{
+		sim_bit_count = 0;
+	}
+	sim_bus.cs_edges += cs_edge;
+	sim_bus.ldac_edges += ldac_edge;
+}
+
+uint8_t AD567XSim::onTransfer(uint8_t data)
+{
+	sim_bus.bytes++;
+	sim_bus.wire_ns += 8000000000ULL / sim_clock;
+
+	uint8_t miso = 0x00;
+	for (uint8_t i = 0; i < sim_num_devices; i++)
+	{
+		AD567XSim *dev = sim_devices[i];
+		if (digitalRead(dev->_CS_pin) != LOW)
+		{
+			continue;
+		}
+
+		// Only the first device of a chain is driven by MOSI
+		bool chained = false;
+		for (uint8_t j = 0; j < sim_num_devices; j++)
+		{
+			chained |= (sim_devices[j]->_next == dev);
+		}
+		if (chained)
+		{
+			continue;
+		}
+
+		uint8_t in = data;
+		while (dev)
+		{
+			// Bit errors above the highest reliable clock
+			uint8_t errors = (dev->_max_clock && sim_clock > dev->_max_clock) ? 0x01 : 0x00;
+			// SDO only forwards the byte if the device was already in daisy-chain mode
+			bool daisy_chain = dev->_daisy_chain;
+			uint8_t out = dev->shiftByte(in ^ errors) ^ errors;
+			miso = out;
+			if (!daisy_chain)
+			{
+				break;
+			}
+			in = out;
+			dev = dev->_next;
+		}
+	}
+	return miso;
+}
+
+uint8_t AD567XSim::peekTransfer()
+{
+	// Byte that onTransfer would return: the top of the shift register of the last device reached
+	uint8_t miso = 0x00;
+	for (uint8_t i = 0; i < sim_num_devices; i++)
+	{
+		AD567XSim *dev = sim_devices[i];
+		if (digitalRead(dev->_CS_pin) != LOW)
+		{
+			continue;
+		}
+		bool chained = false;
+		for (uint8_t j = 0; j < sim_num_devices; j++)
+		{
+			chained |= (sim_devices[j]->_next == dev);
+		}
+		if (chained)
+		{
+			continue;
+		}
+		while (dev->_daisy_chain && dev->_next)
+		{
+			dev = dev->_next;
+		}
+		miso = (dev->_shift >> 16) & 0xFF;
+	}
+	return miso;
+}
+
+void AD567XSim::onSCLKFalling()
+{
+	// The byte read back is known before its first bit, and shifted in once complete
+	if (!sim_bit_count)
+	{
+		sim_bits_out = peekTransfer();
+	}
+	sim_bits_in = (sim_bits_in << 1) | (digitalRead(sim_MOSI_pin) ? 1 : 0);
+	if (sim_MISO_pin != 0xFF)
+	{
+		digitalWrite(sim_MISO_pin, (sim_bits_out >> (7 - sim_bit_count)) & 0x01);
+	}
+	if (++sim_bit_count == 8)
+	{
+		sim_bit_count = 0;
+		onTransfer(sim_bits_in);
+	}
+}
+
+void AD567XSim::attachPins(pin_size_t SCLK_pin, pin_size_t MOSI_pin, pin_size_t MISO_pin)
+{
+	sim_SCLK_pin = SCLK_pin;
+	sim_MOSI_pin = MOSI_pin;
+	sim_MISO_pin = MISO_pin;
+	sim_bit_count = 0;
+}
+
+void AD567XSim::onBeginTransaction(uint32_t clock)
+{
+	sim_bus.transactions++;
+	sim_clock = clock ? clock : 1;
+}
@@ -0,0 +1,121 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+AD567XSim.h - Behavioural model of the AD5674(R)/AD5679(R) 16-channel DACs for host-side builds.
+Each simulated device is attached to a CS (SYNC), LDAC and RESET pin of the host shim. Devices sharing a
+CS pin form a daisy chain in construction order (SDI of the first device is driven by MOSI, MISO is driven
+by the SDO of the last device reached by the data). The devices are clocked by the SPI shim, or bit by bit by the
+SCLK and MOSI pins given to attachPins, e.g. for the bit-banged transport.
+*/
+
+#ifndef AD567X16_HOST_SIM_h
+#define AD567X16_HOST_SIM_h
+
+#include <Arduino.h>
+
+// Traffic counters of the shared SPI bus
+struct AD567XSimBusCounters
+{
+	uint32_t transactions; // beginTransaction calls
+	uint32_t bytes;		   // Bytes clocked on the bus
+	uint32_t cs_edges;	   // Edges on any CS pin attached to a simulated device
+	uint32_t ldac_edges;   // Edges on any LDAC pin attached to a simulated device
+	uint64_t wire_ns;	   // Time spent shifting bits, at the clock of each transaction
+};
+
+class AD567XSim
+{
+
+public:
+	AD567XSim(uint8_t resolution, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin);
+	~AD567XSim();
+
+	// Register contents, as 16-bit register words (the 4 LSBs are always 0 for 12-bit models)
+	word inputRegister(uint8_t channel) const { return _input[channel & 0x0F]; }
+	word dacRegister(uint8_t channel) const { return _dac[channel & 0x0F]; }
+	// Power-down mode of a channel (0: normal operation)
+	uint8_t powerMode(uint8_t channel) const { return _power[channel & 0x0F]; }
+	bool internalReference() const { return _internal_ref; }
+	word ldacMask() const { return _ldac_mask; }
+	bool daisyChain() const { return _daisy_chain; }
+
+	// Number of valid frames decoded, per command
+	uint32_t frames(uint8_t command) const { return _frames[command & 0x0F]; }
+	uint32_t frames() const;
+	// Number of frames ignored because CS was released before 24 bits were clocked
+	uint32_t incompleteFrames() const { return _incomplete; }
+	uint32_t ldacPulses() const { return _ldac_pulses; }
+	void clearCounters();
+
+	// Power-on/RESET state
+	void reset();
+
+	// Highest SCLK frequency the device samples reliably (0: no limit). Above it, the last bit of every byte shifted
+	// in or out is flipped, as with a board whose wiring does not meet the timing at that frequency.
+	void setMaxClock(uint32_t clock) { _max_clock = clock; }
+
+	static AD567XSimBusCounters &bus();
+	static void clearBusCounters();
+
+	// Pins of a bit-banged bus: MOSI is sampled on the falling edges of SCLK, and MISO set right after them
+	static void attachPins(pin_size_t SCLK_pin, pin_size_t MOSI_pin, pin_size_t MISO_pin);
+
+	// Shim hooks
+	static void onPinWrite(pin_size_t pin, uint8_t old_value, uint8_t value);
+	static uint8_t onTransfer(uint8_t data);
+	static void onBeginTransaction(uint32_t clock);
+
+private:
+	uint8_t _resolution;
+	pin_size_t _CS_pin;
+	pin_size_t _LDAC_pin;
+	pin_size_t _RESET_pin;
+
+	word _input[16];
+	word _dac[16];
+	uint8_t _power[16];
+	bool _internal_ref;
+	word _ldac_mask;
+	bool _daisy_chain;
+	uint32_t _max_clock = 0;
+
+	uint32_t _shift;	  // 24-bit input shift register
+	uint32_t _bits;		  // Bits clocked since SYNC went low
+	bool _latched;		  // Standalone mode: frame already executed in this SYNC window
+	bool _ldac_low;
+	int8_t _readback;	  // Channel to clock out during the next frame, -1 if none
+
+	uint32_t _frames[16];
+	uint32_t _incomplete;
+	uint32_t _ldac_pulses;
+
+	AD567XSim *_next = nullptr;
+
+	static uint8_t peekTransfer();
+	static void onSCLKFalling();
+	uint8_t shiftByte(uint8_t data);
+	void syncRising();
+	void execute(uint32_t frame);
+	void loadDAC(word mask);
+	word registerWord(word data) const;
+};
+
+#endif
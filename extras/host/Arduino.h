@@ -0,0 +1,145 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+Arduino.h - Host-side Arduino API shim used to build and exercise the AD567X16 library on Linux.
+Only the subset of the Arduino API used by the library and its examples is provided. Pin writes and
+SPI traffic are routed to the simulated AD567X devices declared in AD567XSim.h.
+*/
+
+#ifndef AD567X16_HOST_ARDUINO_h
+#define AD567X16_HOST_ARDUINO_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+#include "binary.h"
+
+typedef uint8_t byte;
+typedef uint16_t word;
+typedef bool boolean;
+typedef uint8_t pin_size_t;
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+
+#define lowByte(w) ((uint8_t)((w) & 0xff))
+#define highByte(w) ((uint8_t)((w) >> 8))
+
+template <class T, class L>
+auto min(const T &a, const L &b) -> decltype((b < a) ? b : a)
+{
+	return (b < a) ? b : a;
+}
+
+template <class T, class L>
+auto max(const T &a, const L &b) -> decltype((b < a) ? b : a)
+{
+	return (a < b) ? b : a;
+}
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+void pinMode(pin_size_t pin, uint8_t mode);
+void digitalWrite(pin_size_t pin, uint8_t value);
+int digitalRead(pin_size_t pin);
+
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+unsigned long millis();
+unsigned long micros();
+
+void noInterrupts();
+void interrupts();
+
+// Minimal Print implementation, used for Serial and user-supplied log sinks
+class Print
+{
+public:
+	virtual ~Print() {}
+	virtual size_t write(uint8_t c) = 0;
+	virtual size_t write(const uint8_t *buffer, size_t size);
+
+	size_t print(const char *str);
+	size_t print(const __FlashStringHelper *str);
+	size_t print(char c);
+	size_t print(long value, int base = 10);
+	size_t print(unsigned long value, int base = 10);
+	size_t print(int value, int base = 10) { return print((long)value, base); }
+	size_t print(unsigned int value, int base = 10) { return print((unsigned long)value, base); }
+	size_t print(double value, int digits = 2);
+	size_t println();
+	template <typename T>
+	size_t println(T value)
+	{
+		size_t n = print(value);
+		return n + println();
+	}
+	template <typename T>
+	size_t println(T value, int format)
+	{
+		size_t n = print(value, format);
+		return n + println();
+	}
+};
+
+class Stream : public Print
+{
+public:
+	virtual int available() = 0;
+	virtual int read() = 0;
+	virtual int peek() = 0;
+	size_t readBytes(uint8_t *buffer, size_t length);
+	size_t readBytes(char *buffer, size_t length) { return readBytes((uint8_t *)buffer, length); }
+};
+
+class HostSerial : public Stream
+{
+public:
+	void begin(unsigned long) {}
+	size_t write(uint8_t c) override;
+	using Print::write;
+	int available() override { return 0; }
+	int read() override { return -1; }
+	int peek() override { return -1; }
+	operator bool() const { return true; }
+};
+
+extern HostSerial Serial;
+
+#endif
@@ -0,0 +1,193 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+ArduinoHost.cpp - Host-side implementation of the Arduino/SPI shim.
+Time is virtual: it only advances through delay(), delayMicroseconds() and the bits shifted on the SPI bus,
+so that host runs are deterministic.
+*/
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <stdio.h>
+
+#include "AD567XSim.h"
+
+HostSerial Serial;
+SPIClass SPI;
+
+static uint8_t host_pins[256];
+static uint64_t host_time_ns = 0;
+
+void pinMode(pin_size_t, uint8_t) {}
+
+void digitalWrite(pin_size_t pin, uint8_t value)
+{
+	uint8_t old_value = host_pins[pin];
+	host_pins[pin] = value ? HIGH : LOW;
+	AD567XSim::onPinWrite(pin, old_value, host_pins[pin]);
+}
+
+int digitalRead(pin_size_t pin)
+{
+	return host_pins[pin];
+}
+
+void delay(unsigned long ms)
+{
+	host_time_ns += (uint64_t)ms * 1000000ULL;
+}
+
+void delayMicroseconds(unsigned int us)
+{
+	host_time_ns += (uint64_t)us * 1000ULL;
+}
+
+unsigned long millis()
+{
+	return (unsigned long)(host_time_ns / 1000000ULL);
+}
+
+unsigned long micros()
+{
+	return (unsigned long)(host_time_ns / 1000ULL);
+}
+
+void noInterrupts() {}
+void interrupts() {}
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+	size_t n = 0;
+	while (size--)
+	{
+		n += write(*buffer++);
+	}
+	return n;
+}
+
+size_t Print::print(const char *str)
+{
+	return write((const uint8_t *)str, strlen(str));
+}
+
+size_t Print::print(const __FlashStringHelper *str)
+{
+	return print(reinterpret_cast<const char *>(str));
+}
+
+size_t Print::print(char c)
+{
+	return write((uint8_t)c);
+}
+
+size_t Print::print(long value, int base)
+{
+	char buf[40];
+	if (base == 16)
+	{
+		snprintf(buf, sizeof(buf), "%lX", value);
+	}
+	else
+	{
+		snprintf(buf, sizeof(buf), "%ld", value);
+	}
+	return print(buf);
+}
+
+size_t Print::print(unsigned long value, int base)
+{
+	char buf[40];
+	if (base == 16)
+	{
+		snprintf(buf, sizeof(buf), "%lX", value);
+	}
+	else
+	{
+		snprintf(buf, sizeof(buf), "%lu", value);
+	}
+	return print(buf);
+}
+
+size_t Print::print(double value, int digits)
+{
+	char buf[64];
+	snprintf(buf, sizeof(buf), "%.*f", digits, value);
+	return print(buf);
+}
+
+size_t Print::println()
+{
+	return write((const uint8_t *)"\r\n", 2);
+}
+
+size_t Stream::readBytes(uint8_t *buffer, size_t length)
+{
+	size_t n = 0;
+	while (n < length)
+	{
+		int c = read();
+		if (c < 0)
+		{
+			break;
+		}
+		buffer[n++] = (uint8_t)c;
+	}
+	return n;
+}
+
+size_t HostSerial::write(uint8_t c)
+{
+	return fputc(c, stdout) == EOF ? 0 : 1;
+}
+
+void SPIClass::beginTransaction(SPISettings settings)
+{
+	_settings = settings;
+	_in_transaction = true;
+	AD567XSim::onBeginTransaction(settings.clock);
+}
+
+void SPIClass::endTransaction()
+{
+	_in_transaction = false;
+}
+
+uint8_t SPIClass::transfer(uint8_t data)
+{
+	host_time_ns += 8000000000ULL / (_settings.clock ? _settings.clock : 1);
+	return AD567XSim::onTransfer(data);
+}
+
+uint16_t SPIClass::transfer16(uint16_t data)
+{
+	uint16_t hi = transfer(data >> 8);
+	uint16_t lo = transfer(data & 0xFF);
+	return (hi << 8) | lo;
+}
+
+void SPIClass::transfer(void *buf, size_t count)
+{
+	uint8_t *p = (uint8_t *)buf;
+	for (size_t i = 0; i < count; i++)
+	{
+		p[i] = transfer(p[i]);
+	}
+}
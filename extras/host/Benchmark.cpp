@@ -0,0 +1,213 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+Benchmark.cpp - Bus cost of the public API of the AD567X16 library, measured against a simulated AD5674 device.
+Each benchmark runs an operation a fixed number of times and prints one JSON object per line, with the per-operation
+averages of the SPI transactions, bytes, frames executed by the device, frames elided by the driver, CS and LDAC edges,
+host time and time on the wire at the selected SCLK frequency. The first line gives the size of a device object.
+Usage: AD567X16_bench [SCLK in Hz] [operations per benchmark]
+*/
+
+#include <Arduino.h>
+#include <AD567X16.h>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "AD567XSim.h"
+
+#define CS_PIN 10
+#define LDAC_PIN 9
+#define RESET_PIN 8
+
+static AD567XSim sim_DAC __attribute__((init_priority(101)))(12, CS_PIN, LDAC_PIN, RESET_PIN);
+static AD5674Class DAC(CS_PIN, LDAC_PIN, RESET_PIN, 2.5);
+
+static uint32_t sclk = 10000000;
+static long operations = 1000;
+
+typedef void (*BenchOperation)(long i);
+
+static void bench(const char *name, BenchOperation operation)
+{
+	// Start every benchmark from the same device state
+	DAC.resetRegisters();
+	DAC.setSPIClock(sclk);
+	DAC.clearFrameCounters();
+	sim_DAC.clearCounters();
+	AD567XSim::clearBusCounters();
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (long i = 0; i < operations; i++)
+	{
+		operation(i);
+	}
+	double host_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+	const AD567XSimBusCounters &bus = AD567XSim::bus();
+	double n = (double)operations;
+	printf("{\"name\":\"%s\",\"ops\":%ld,\"sclk\":%lu,\"transactions\":%.3f,\"bytes\":%.3f,\"frames\":%.3f,"
+		   "\"elided\":%.3f,\"cs_edges\":%.3f,\"ldac_edges\":%.3f,\"host_ns\":%.1f,\"wire_us\":%.3f,\"incomplete\":%lu}\n",
+		   name, operations, (unsigned long)sclk, bus.transactions / n, bus.bytes / n, sim_DAC.frames() / n,
+		   DAC.framesElided() / n, bus.cs_edges / n, bus.ldac_edges / n, host_ns / n, bus.wire_ns / n / 1000.0,
+		   (unsigned long)sim_DAC.incompleteFrames());
+}
+
+// Codes changing at every operation, so that the driver cannot elide the writes
+static word code(long i, uint8_t channel = 0)
+{
+	return (word)((i * 37 + channel * 256 + 1) & 0x0FFF);
+}
+
+static uint8_t all_channels[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+
+// Startup state of the boot benchmarks: most channels at mid-scale, two powered down, a masked group
+static word boot_values[16] = {0x800, 0x800, 0x800, 0x123, 0x800, 0x800, 0x800, 0x800,
+							   0x800, 0xFFF, 0x800, 0x800, 0x800, 0x800, 0x800, 0x800};
+static uint8_t boot_off[2] = {14, 15};
+static bool boot_power[2] = {false, false};
+static AD567X16Snapshot boot_snapshot;
+
+// Startup as done by hand: reference, every channel, power state and LDAC mask, one call at a time
+static void bootByHand()
+{
+	DAC.resetRegisters();
+	DAC.setReference(2.5f);
+	for (uint8_t ch = 0; ch < 16; ch++)
+	{
+		DAC.setChannel(ch, boot_values[ch]);
+	}
+	DAC.powerUpDown(boot_off, boot_power, 2);
+	DAC.updateDAC();
+	DAC.setLDACMask(0x00F0);
+}
+
+int main(int argc, char **argv)
+{
+	if (argc > 1)
+	{
+		sclk = strtoul(argv[1], NULL, 10);
+	}
+	if (argc > 2)
+	{
+		operations = atol(argv[2]);
+	}
+	if (!sclk || operations <= 0)
+	{
+		fprintf(stderr, "Usage: %s [SCLK in Hz] [operations per benchmark]\n", argv[0]);
+		return 2;
+	}
+
+	// RAM taken by a device object, on the host
+	printf("{\"name\":\"sizeof_AD5674Class\",\"bytes\":%lu}\n", (unsigned long)sizeof(AD5674Class));
+
+	// Single calls of the public API
+	bench("setChannel_word", [](long i)
+		  { DAC.setChannel(i & 0x0F, code(i)); });
+	bench("setChannel_word_update", [](long i)
+		  { DAC.setChannel(i & 0x0F, code(i), true); });
+	bench("setChannel_float", [](long i)
+		  { DAC.setChannel(i & 0x0F, (float)(code(i) * 2.5 / 4096)); });
+	bench("setChannel_unchanged", [](long)
+		  { DAC.setChannel(0, (word)0x0800); });
+	bench("setChannelMillivolts", [](long i)
+		  { DAC.setChannelMillivolts(i & 0x0F, (uint16_t)(i % 2500)); });
+	bench("updateChannels_4", [](long)
+		  { uint8_t channels[4] = {0, 1, 2, 3};
+			DAC.updateChannels(channels, 4); });
+	bench("updateDAC", [](long)
+		  { DAC.updateDAC(); });
+	bench("powerUpDown_channel", [](long i)
+		  { DAC.powerUpDown(i & 0x0F, i & 0x10); });
+	bench("powerUpDown_16", [](long i)
+		  { bool power_up[16];
+			for (uint8_t ch = 0; ch < 16; ch++)
+			{
+				power_up[ch] = (i + ch) & 1;
+			}
+			DAC.powerUpDown(all_channels, power_up, 16); });
+	bench("setReference", [](long i)
+		  { DAC.setReference((float)(2.5 + (i & 1) * 0.8)); });
+	bench("setLDACMask", [](long i)
+		  { DAC.setLDACMask((word)i); });
+	bench("setAll", [](long i)
+		  { DAC.setAll(code(i), true); });
+
+	// Typical workloads
+	bench("refresh_16_setChannel", [](long i)
+		  { for (uint8_t ch = 0; ch < 16; ch++)
+			{
+				DAC.setChannel(ch, code(i, ch));
+			}
+			DAC.updateDAC(); });
+	bench("refresh_16_setChannels", [](long i)
+		  { word values[16];
+			for (uint8_t ch = 0; ch < 16; ch++)
+			{
+				values[ch] = code(i, ch);
+			}
+			DAC.setChannels(values, false, true); });
+	bench("refresh_16_flush", [](long i)
+		  { for (uint8_t ch = 0; ch < 16; ch++)
+			{
+				DAC.stageChannel(ch, code(i, ch));
+			}
+			DAC.flush(); });
+	bench("refresh_16_one_changed", [](long i)
+		  { word values[16];
+			for (uint8_t ch = 0; ch < 16; ch++)
+			{
+				values[ch] = (word)(ch * 256);
+			}
+			values[i & 0x0F] = code(i);
+			DAC.setChannels(values, false, true); });
+	bench("sawtooth_example", [](long i)
+		  { // Loop of examples/AD5674_example.cpp: every other channel, then one LDAC pulse
+			word value = (word)((i * 100) % 4096);
+			for (uint8_t ch = 0; ch < 16; ch += 2)
+			{
+				DAC.setChannel(ch, value);
+			}
+			DAC.updateDAC(); });
+	bench("power_cycle_16", [](long)
+		  { bool power_up[16];
+			for (uint8_t ch = 0; ch < 16; ch++)
+			{
+				power_up[ch] = false;
+			}
+			DAC.powerUpDown(all_channels, power_up, 16);
+			for (uint8_t ch = 0; ch < 16; ch++)
+			{
+				power_up[ch] = true;
+			}
+			DAC.powerUpDown(all_channels, power_up, 16); });
+
+	// Startup from RESET to valid outputs: wire_us is the time to valid output
+	bootByHand();
+	DAC.snapshot(boot_snapshot);
+	bench("boot_by_hand", [](long)
+		  { bootByHand(); });
+	bench("boot_restore", [](long)
+		  { DAC.resetRegisters();
+			DAC.restore(boot_snapshot); });
+
+	return sim_DAC.incompleteFrames() ? 1 : 0;
+}
@@ -0,0 +1,76 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+ExampleRunner.cpp - Runs the AD5674 example sketch on the host, against two simulated AD5674(R) devices.
+Prints the register contents of the devices and the bus counters, and fails if the devices received malformed frames.
+Usage: AD5674_example [loop iterations]
+*/
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "AD567XSim.h"
+
+void setup();
+void loop();
+
+// Created before the sketch objects, so that the devices see the initialization sequence
+static AD567XSim sim_DAC __attribute__((init_priority(101)))(12, 10, 9, 8);
+static AD567XSim sim_DAC_R __attribute__((init_priority(101)))(12, 7, 6, 5);
+
+static bool report(const char *name, const AD567XSim &sim)
+{
+	printf("%s: %lu frames, %lu LDAC pulses, %lu incomplete frames\n", name, (unsigned long)sim.frames(),
+		   (unsigned long)sim.ldacPulses(), (unsigned long)sim.incompleteFrames());
+	printf("  DAC:  ");
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		printf(" %04X", sim.dacRegister(i));
+	}
+	printf("\n  power:");
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		printf(" %4u", sim.powerMode(i));
+	}
+	printf("\n");
+	return sim.incompleteFrames() == 0;
+}
+
+int main(int argc, char **argv)
+{
+	long iterations = (argc > 1) ? atol(argv[1]) : 100;
+
+	setup();
+	for (long i = 0; i < iterations; i++)
+	{
+		loop();
+	}
+
+	const AD567XSimBusCounters &bus = AD567XSim::bus();
+	printf("bus: %lu transactions, %lu bytes, %lu CS edges, %lu LDAC edges, %.1f us on the wire, %lu ms elapsed\n",
+		   (unsigned long)bus.transactions, (unsigned long)bus.bytes, (unsigned long)bus.cs_edges,
+		   (unsigned long)bus.ldac_edges, bus.wire_ns / 1000.0, millis());
+
+	bool ok = report("AD5674", sim_DAC);
+	ok &= report("AD5674R", sim_DAC_R);
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+csv2prog.cpp - Compiles a CSV table of setpoints into an AD567X16 frame program (see AD567X16Program.h).
+The first line gives the channels of the columns, after the delay column, e.g. "delay_us,0,1,2". Each following line
+waits for its delay in microseconds, writes the values that changed since the previous line (in codes of the model
+resolution, an empty cell keeping the previous value) to the input registers, then pulses LDAC.
+Usage: csv2prog [-b bits] [-d] [-c name] input.csv output
+  -b bits  resolution of the model, 12 or 16 (default: 12)
+  -d       write the DAC registers directly, without LDAC pulses
+  -c name  write a C array named name, stored in PROGMEM, instead of a binary file
+*/
+
+#include <Arduino.h>
+#include <AD567X16Program.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+static void usage(const char *name)
+{
+	fprintf(stderr, "Usage: %s [-b bits] [-d] [-c name] input.csv output\n", name);
+	exit(2);
+}
+
+// Splits a CSV line in place, returning the number of fields
+static int splitLine(char *line, char **fields, int max_fields)
+{
+	int count = 0;
+	line[strcspn(line, "\r\n")] = 0;
+	for (char *field = line; count < max_fields;)
+	{
+		fields[count++] = field;
+		char *comma = strchr(field, ',');
+		if (!comma)
+		{
+			break;
+		}
+		*comma = 0;
+		field = comma + 1;
+	}
+	return count;
+}
+
+static bool emptyField(const char *field)
+{
+	return field[strspn(field, " \t")] == 0;
+}
+
+int main(int argc, char **argv)
+{
+	int bits = 12;
+	bool DAC_update = false;
+	const char *array_name = NULL;
+
+	int arg = 1;
+	for (; arg < argc && argv[arg][0] == '-'; arg++)
+	{
+		if (!strcmp(argv[arg], "-b") && arg + 1 < argc)
+		{
+			bits = atoi(argv[++arg]);
+		}
+		else if (!strcmp(argv[arg], "-d"))
+		{
+			DAC_update = true;
+		}
+		else if (!strcmp(argv[arg], "-c") && arg + 1 < argc)
+		{
+			array_name = argv[++arg];
+		}
+		else
+		{
+			usage(argv[0]);
+		}
+	}
+	if (argc - arg != 2 || (bits != 12 && bits != 16))
+	{
+		usage(argv[0]);
+	}
+
+	FILE *input = fopen(argv[arg], "r");
+	if (!input)
+	{
+		perror(argv[arg]);
+		return 1;
+	}
+
+	char line[1024];
+	char *fields[17];
+	uint8_t channels[16];
+	int num_channels = 0;
+
+	// Header: delay column, then one channel per column
+	if (!fgets(line, sizeof(line), input))
+	{
+		fprintf(stderr, "%s: empty file\n", argv[arg]);
+		return 1;
+	}
+	int num_fields = splitLine(line, fields, 17);
+	for (int i = 1; i < num_fields; i++)
+	{
+		int channel = atoi(fields[i]);
+		if (channel < 0 || channel > 15)
+		{
+			fprintf(stderr, "%s: invalid channel %s\n", argv[arg], fields[i]);
+			return 1;
+		}
+		channels[num_channels++] = channel;
+	}
+
+	// Each line is encoded in its own program, large enough for the worst case (the longest delay, 16 frames and an
+	// LDAC pulse), then appended to the output
+	std::vector<byte> output_program;
+	byte line_buffer[128 * AD567X16_FRAME_SIZE];
+	AD567X16ProgramClass program(line_buffer, sizeof(line_buffer));
+	long values[16];
+	for (int i = 0; i < 16; i++)
+	{
+		values[i] = -1; // Unknown, always written first
+	}
+
+	byte command = DAC_update ? AD567X16_CMD_WRITE_DAC_REG : AD567X16_CMD_WRITE_INPUT_REG;
+	unsigned line_number = 1;
+	size_t rows = 0;
+
+	while (fgets(line, sizeof(line), input))
+	{
+		line_number++;
+		num_fields = splitLine(line, fields, 17);
+		if (num_fields == 1 && emptyField(fields[0]))
+		{
+			continue;
+		}
+
+		program.clear();
+		program.delayMicros(strtoul(fields[0], NULL, 10));
+
+		bool changed = false;
+		for (int i = 1; i < num_fields && i <= num_channels; i++)
+		{
+			if (emptyField(fields[i]))
+			{
+				continue;
+			}
+
+			long value = strtol(fields[i], NULL, 10);
+			if (value < 0 || value >= (1L << bits))
+			{
+				fprintf(stderr, "%s:%u: value %ld out of range\n", argv[arg], line_number, value);
+				return 1;
+			}
+
+			uint8_t channel = channels[i - 1];
+			if (value != values[channel])
+			{
+				program.append(command, channel, (word)(value << (16 - bits)));
+				values[channel] = value;
+				changed = true;
+			}
+		}
+		if (changed && !DAC_update)
+		{
+			program.LDAC();
+		}
+		output_program.insert(output_program.end(), program.data(), program.data() + program.length());
+		rows++;
+	}
+	fclose(input);
+	program.clear();
+	program.end();
+	output_program.insert(output_program.end(), program.data(), program.data() + program.length());
+
+	FILE *output = fopen(argv[arg + 1], array_name ? "w" : "wb");
+	if (!output)
+	{
+		perror(argv[arg + 1]);
+		return 1;
+	}
+	if (array_name)
+	{
+		fprintf(output, "// Generated by csv2prog from %s\n", argv[arg]);
+		fprintf(output, "const byte %s[%u] PROGMEM = {", array_name, (unsigned)output_program.size());
+		for (size_t i = 0; i < output_program.size(); i++)
+		{
+			fprintf(output, "%s0x%02X", (i % 12) ? ", " : (i ? ",\n\t" : "\n\t"), output_program[i]);
+		}
+		fprintf(output, "};\n");
+	}
+	else
+	{
+		fwrite(output_program.data(), 1, output_program.size(), output);
+	}
+	fclose(output);
+
+	fprintf(stderr, "%lu lines, %lu records, %lu bytes\n", (unsigned long)rows,
+			(unsigned long)(output_program.size() / AD567X16_FRAME_SIZE), (unsigned long)output_program.size());
+	return 0;
+}
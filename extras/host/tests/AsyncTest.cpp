@@ -0,0 +1,113 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+AsyncTest.cpp - Checks the non-blocking transfers with the polled backend, and the calls bracketing each run of
+frames.
+*/
+
+#include <AD567X16Async.h>
+#include "AD567XSim.h"
+#include "HostTest.h"
+
+// Polled backend counting the runs of frames
+class CountingBackend : public AD567X16PolledBackend
+{
+
+public:
+	int runs = 0;
+	bool running = false;
+
+	void beginFrames() override
+	{
+		CHECK(!running);
+		running = true;
+		runs++;
+	}
+	void endFrames() override
+	{
+		CHECK(running);
+		running = false;
+	}
+};
+
+static void onDone(void *context)
+{
+	(*(int *)context)++;
+}
+
+int main()
+{
+	AD567XSim sim(16, 10, 9, 8);
+	AD5679RClass DAC(10, 9, 8);
+	CountingBackend backend;
+	AD567X16AsyncClass async(DAC, backend);
+	int batches = 0;
+	async.begin();
+	async.onComplete(onDone, &batches);
+
+	uint8_t channels[3] = {1, 2, 3};
+	word values[3] = {100, 200, 300};
+	CHECK(async.setChannels(channels, values, 3));
+	CHECK(async.commit());
+	CHECK(async.busy() && backend.running);
+	while (backend.poll())
+	{
+	}
+	CHECK(!async.busy() && !backend.running && backend.runs == 1 && batches == 1);
+	CHECK(sim.dacRegister(1) == 100 && sim.dacRegister(2) == 200 && sim.dacRegister(3) == 300);
+	CHECK(sim.ldacPulses() == 1);
+
+	// Unchanged values are not queued: an empty batch completes right away, without a run of frames
+	CHECK(async.setChannels(channels, values, 3) && !async.busy());
+	CHECK(async.commit(false) && batches == 2 && backend.runs == 1);
+
+	// The blocking functions work again once the queue is empty
+	DAC.setChannel(5, (word)500, true);
+	CHECK(sim.dacRegister(5) == 500);
+	CHECK(async.write(AD567X16_CMD_WRITE_DAC_REG, 6, 600) && backend.poll() && !backend.poll());
+	CHECK(sim.dacRegister(6) == 600 && backend.runs == 2 && !backend.running);
+
+	// A write queued after a commit is not latched by its pulse: the DAC register is still written afterwards
+	CHECK(async.setChannel(0, 111, true) && async.commit());
+	CHECK(async.setChannel(0, 777));
+	while (backend.poll())
+	{
+	}
+	CHECK(sim.dacRegister(0) == 111 && sim.inputRegister(0) == 777);
+	DAC.clearFrameCounters();
+	CHECK(DAC.setChannel(0, (word)777, true) == AD567X16_OK && DAC.framesElided() == 0);
+	CHECK(sim.dacRegister(0) == 777);
+
+	// After a group commit, the LDAC mask is restored by a queued frame, before the pulse
+	DAC.defineGroup(0, 0x0003);
+	DAC.setChannel(0, (word)10);
+	DAC.setChannel(1, (word)20);
+	DAC.commitGroup(0);
+	CHECK(sim.ldacMask() == 0xFFFC);
+	uint32_t pulses = sim.ldacPulses();
+	CHECK(async.setChannel(4, 400) && async.commit());
+	while (backend.poll())
+	{
+	}
+	CHECK(sim.ldacMask() == 0x0000 && sim.ldacPulses() == pulses + 1 && sim.dacRegister(4) == 400);
+	CHECK(DAC.LDACMask() == 0x0000);
+	return hostTestResult();
+}
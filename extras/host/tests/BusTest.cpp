@@ -0,0 +1,77 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+BusTest.cpp - Checks the coordinated commits of several devices sharing the SPI bus against the simulated devices:
+single transaction, LDAC pulses per pin, elided values and LDAC mask restore.
+*/
+
+#include <AD567X16Bus.h>
+#include "AD567XSim.h"
+#include "HostTest.h"
+
+int main()
+{
+	AD567XSim simA(12, 10, 9, 8);
+	AD567XSim simB(16, 7, 6, 5);
+	AD5674RClass A(10, 9, 8);
+	AD5679RClass B(7, 6, 5);
+	AD567X16BusClass bus;
+	CHECK(bus.addDevice(A) == AD567X16_OK && bus.addDevice(B) == AD567X16_OK && bus.numDevices() == 2);
+	CHECK(bus.stageChannel(2, 0, (word)1) == AD567X16_ERROR_DEVICE);
+
+	// The staged values of both devices go out in one transaction, then both LDAC pins are pulsed
+	bus.stageChannel(0, 1, (word)100);
+	bus.stageChannel(1, 2, (word)200);
+	bus.stageChannel(1, 3, (word)300);
+	AD567XSim::clearBusCounters();
+	bus.commit();
+	CHECK(AD567XSim::bus().transactions == 1 && bus.lastCommitFrames() == 3);
+	CHECK(simA.dacRegister(1) == 100 << 4 && simB.dacRegister(2) == 200 && simB.dacRegister(3) == 300);
+	CHECK(simA.ldacPulses() == 1 && simB.ldacPulses() == 1);
+
+	// Unchanged values are elided, and a device without changes is not pulsed
+	bus.stageChannel(0, 1, (word)100);
+	bus.stageChannel(1, 2, (word)201);
+	bus.commit();
+	CHECK(bus.lastCommitFrames() == 1 && simA.ldacPulses() == 1 && simB.ldacPulses() == 2);
+
+	// A value already in the input register is elided, but still needs the pulse to reach the output
+	A.setChannel(0, (word)500);
+	bus.stageChannel(0, 0, (word)500);
+	bus.commit();
+	CHECK(bus.lastCommitFrames() == 0 && simA.dacRegister(0) == 500 << 4 && simA.ldacPulses() == 2);
+
+	// Without the LDAC commit, the DAC registers are written directly
+	bus.stageChannel(1, 4, (word)400);
+	bus.commit(false);
+	CHECK(simB.dacRegister(4) == 400 && simB.ldacPulses() == 2);
+
+	// After a group commit, the LDAC mask set by the application is restored before the pulse
+	B.setLDACMask(0x8000);
+	B.defineGroup(0, 0x00FF);
+	B.commitGroup(0);
+	CHECK(simB.ldacMask() == 0xFF00);
+	bus.stageChannel(1, 3, (word)33);
+	bus.stageChannel(1, 12, (word)44);
+	bus.commit();
+	CHECK(simB.dacRegister(3) == 33 && simB.dacRegister(12) == 44 && simB.ldacMask() == 0x8000);
+	return hostTestResult();
+}
@@ -0,0 +1,90 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+ChainTest.cpp - Checks a daisy chain of devices sharing the CS, LDAC and RESET pins against the simulated devices:
+no traffic before begin(), daisy-chain mode on every device, slot order, no-operation fill and chain-wide updates.
+*/
+
+#include <AD567X16Chain.h>
+#include "AD567XSim.h"
+#include "HostTest.h"
+
+int main()
+{
+	// The simulated devices sharing the CS pin form the chain in construction order, sim[0] next to MOSI
+	AD567XSim sim[3] = {AD567XSim(16, 10, 9, 8), AD567XSim(16, 10, 9, 8), AD567XSim(16, 10, 9, 8)};
+	AD567XSim::clearBusCounters();
+	AD567X16ChainClass chain(3, 16, 10, 9, 8);
+	CHECK(chain.numDevices() == 3);
+
+	// The constructor leaves the bus alone, begin() enables the daisy-chain mode on every device
+	CHECK(AD567XSim::bus().bytes == 0 && AD567XSim::bus().transactions == 0);
+	chain.begin();
+	for (uint8_t d = 0; d < 3; d++)
+	{
+		CHECK(sim[d].daisyChain() && sim[d].incompleteFrames() == 0);
+		sim[d].clearCounters();
+	}
+
+	// The frame of device d reaches sim[d] (the last device is shifted first), the others receive a no-operation
+	CHECK(chain.setChannel(0, 1, (word)100) == AD567X16_OK);
+	CHECK(chain.setChannel(2, 3, (word)300, 1) == AD567X16_OK);
+	CHECK(chain.setChannel(3, 0, (word)1) == AD567X16_ERROR_DEVICE && chain.setChannel(0, 16, (word)1) == AD567X16_ERROR_CHANNEL);
+	AD567XSim::clearBusCounters();
+	chain.transfer();
+	CHECK(AD567XSim::bus().transactions == 1 && AD567XSim::bus().bytes == 3 * AD567X16_FRAME_SIZE);
+	CHECK(sim[0].inputRegister(1) == 100 && sim[0].dacRegister(1) == 0);
+	CHECK(sim[1].frames(AD567X16_CMD_NOP) == 1 && sim[1].frames() == 1);
+	CHECK(sim[2].inputRegister(3) == 300 && sim[2].dacRegister(3) == 300);
+
+	// The slots are cleared after each transfer
+	chain.transfer();
+	for (uint8_t d = 0; d < 3; d++)
+	{
+		CHECK(sim[d].frames(AD567X16_CMD_NOP) == (d == 1 ? 2u : 1u));
+	}
+
+	// 16 x 3 channels in 16 chain-wide transfers within one transaction, then one pulse of the shared LDAC pin
+	word values[3 * 16];
+	for (uint8_t i = 0; i < 3 * 16; i++)
+	{
+		values[i] = 1000 + i;
+	}
+	AD567XSim::clearBusCounters();
+	chain.setChannels(values, 0, 1);
+	CHECK(AD567XSim::bus().transactions == 1 && AD567XSim::bus().bytes == 16 * 3 * AD567X16_FRAME_SIZE);
+	bool loaded = true;
+	for (uint8_t d = 0; d < 3; d++)
+	{
+		for (uint8_t c = 0; c < 16; c++)
+		{
+			loaded = loaded && sim[d].dacRegister(c) == values[d * 16 + c];
+		}
+		CHECK(sim[d].ldacPulses() == 1 && sim[d].incompleteFrames() == 0);
+	}
+	CHECK(loaded);
+
+	// A reset disables the daisy-chain mode, resetRegisters enables it again
+	chain.resetRegisters();
+	CHECK(sim[0].daisyChain() && sim[1].daisyChain() && sim[2].daisyChain() && sim[2].dacRegister(0) == 0);
+
+	return hostTestResult();
+}
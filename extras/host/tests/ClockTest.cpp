@@ -0,0 +1,107 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+ClockTest.cpp - Checks characterizeSPIClock against simulated devices that corrupt the bits above a given clock.
+*/
+
+#include <AD567X16.h>
+#include "AD567XSim.h"
+#include "HostTest.h"
+
+static int check_calls = 0;
+
+// Bus check passing up to the clock given as context
+static bool checkLimit(AD567X16Class &DAC, void *context)
+{
+	check_calls++;
+	return DAC.SPIClock() <= *(uint32_t *)context;
+}
+
+static void testLimit16()
+{
+	AD567XSim sim(16, 10, 9, 8);
+	sim.setMaxClock(8000000);
+	AD5679RClass DAC(10, 9, 8);
+
+	// Set up below the limit, the default 10 MHz being above it
+	DAC.setSPIClock(4000000);
+	DAC.setChannel(3, (word)5000, true);
+	DAC.setChannel(3, (word)6000);
+	DAC.setChannel(4, (word)1, true);
+	DAC.setLDACMask(0x0F00);
+	sim.clearCounters();
+
+	CHECK(DAC.characterizeSPIClock(20000000, 20) == AD567X16_OK);
+	CHECK(DAC.SPIClock() <= 8000000 * 80 / 100 && DAC.SPIClock() >= 4000000);
+
+	// Registers written back, LDAC mask and pin left alone
+	CHECK(sim.dacRegister(3) == 5000 && sim.inputRegister(3) == 6000 && sim.dacRegister(4) == 1);
+	CHECK(sim.ldacMask() == 0x0F00 && sim.ldacPulses() == 0);
+	word value = 0;
+	CHECK(DAC.readChannel(3, value) == AD567X16_OK && value == 5000);
+	CHECK(sim.incompleteFrames() == 0);
+}
+
+static void testLimit12()
+{
+	AD567XSim sim(12, 10, 9, 8);
+	sim.setMaxClock(20000000);
+	AD5674RClass DAC(10, 9, 8);
+
+	DAC.setChannel(2, (word)1234, true);
+	CHECK(DAC.characterizeSPIClock() == AD567X16_OK);
+	CHECK(DAC.SPIClock() < 20000000 && DAC.SPIClock() >= 12000000);
+	CHECK(sim.dacRegister(2) == 1234 << 4);
+
+	// Already known registers are not written again
+	DAC.clearFrameCounters();
+	DAC.setChannel(2, (word)1234, true);
+	CHECK(DAC.framesSent() == 0);
+
+	// Saved in the snapshots
+	AD567X16Snapshot snapshot;
+	CHECK(DAC.snapshot(snapshot) == AD567X16_OK && snapshot.SPI_clock == DAC.SPIClock());
+	DAC.setSPIClock();
+	CHECK(DAC.restore(snapshot) == AD567X16_OK && DAC.SPIClock() == snapshot.SPI_clock);
+}
+
+static void testCheckAndFailure()
+{
+	AD567XSim sim(12, 10, 9, 8);
+	AD5674RClass DAC(10, 9, 8);
+
+	uint32_t limit = 5000000;
+	CHECK(DAC.characterizeSPIClock(50000000, 10, checkLimit, &limit) == AD567X16_OK);
+	CHECK(DAC.SPIClock() <= limit * 90 / 100 && check_calls > 1);
+
+	// Fails at the first clock: unchanged
+	sim.setMaxClock(500000);
+	uint32_t previous = DAC.SPIClock();
+	CHECK(DAC.characterizeSPIClock() == AD567X16_ERROR_STATE && DAC.SPIClock() == previous);
+}
+
+int main()
+{
+	testLimit16();
+	testLimit12();
+	testCheckAndFailure();
+	return hostTestResult();
+}
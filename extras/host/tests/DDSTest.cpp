@@ -0,0 +1,116 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+DDSTest.cpp - Checks the DDS waveforms, the ticks written to the simulated device and their timing with poll().
+*/
+
+#include <AD567X16DDS.h>
+#include "AD567XSim.h"
+#include "HostTest.h"
+
+// Code written for a full-scale wave of the 12-bit models at a phase
+static word expected(AD567X16Waveform waveform, uint32_t phase)
+{
+	int32_t code = (int32_t)(2048 << 4) + (((int32_t)AD567X16DDSClass::sample(waveform, phase) * (2047 << 4)) >> 15);
+	return (word)constrain(code, (int32_t)0, (int32_t)0xFFFF) >> 4;
+}
+
+static void testSamples()
+{
+	CHECK(AD567X16DDSClass::sample(AD567X16_SINE, 0) == 0);
+	CHECK(AD567X16DDSClass::sample(AD567X16_SINE, 0x40000000) == 32767);
+	CHECK(AD567X16DDSClass::sample(AD567X16_SINE, 0xC0000000) == -32767);
+	CHECK(AD567X16DDSClass::sample(AD567X16_TRIANGLE, 0) == -0x7FFF);
+	CHECK(AD567X16DDSClass::sample(AD567X16_TRIANGLE, 0x80000000) == 0x7FFF);
+	CHECK(AD567X16DDSClass::sample(AD567X16_SAW, 0) == -0x7FFF);
+	CHECK(AD567X16DDSClass::sample(AD567X16_SQUARE, 0x7FFFFFFF) == 0x7FFF);
+	CHECK(AD567X16DDSClass::sample(AD567X16_SQUARE, 0x80000000) == -0x7FFF);
+}
+
+static void testTicks()
+{
+	AD567XSim sim(12, 10, 9, 8);
+	AD5674RClass DAC(10, 9, 8);
+	AD567X16DDSClass dds(DAC);
+
+	// 250 Hz at 2 kHz: an eighth of a period per tick, also for the frequency set before the sample rate
+	dds.setChannel(0, AD567X16_SINE, 250000, 2047, 2048);
+	dds.setSampleRate(2000);
+	dds.setChannel(1, AD567X16_SINE, 250000, 2047, 2048);
+	dds.setPhase(1, 0x4000);
+	dds.sync();
+
+	for (uint32_t ticks = 0; ticks < 16; ticks++)
+	{
+		AD567XSim::clearBusCounters();
+		uint32_t pulses = sim.ldacPulses();
+		dds.tick();
+		CHECK(AD567XSim::bus().transactions == 1 && sim.ldacPulses() == pulses + 1);
+		CHECK((sim.dacRegister(0) >> 4) == expected(AD567X16_SINE, ticks << 29));
+		CHECK((sim.dacRegister(1) >> 4) == expected(AD567X16_SINE, (ticks << 29) + 0x40000000));
+	}
+
+	// Disabled channels are held
+	dds.disable(1);
+	word held = sim.dacRegister(1);
+	dds.tick();
+	CHECK(sim.dacRegister(1) == held && dds.enabledChannels() == 0x0001);
+}
+
+// Number of ticks run by poll() over a period of virtual time
+static int pollFor(AD567X16DDSClass &dds, unsigned long duration_us, unsigned long interval_us)
+{
+	int ticks = 0;
+	unsigned long start = micros();
+	while (micros() - start < duration_us)
+	{
+		ticks += dds.poll();
+		delayMicroseconds(interval_us);
+	}
+	return ticks;
+}
+
+static void testPoll()
+{
+	AD567XSim sim(12, 10, 9, 8);
+	AD5674RClass DAC(10, 9, 8);
+	AD567X16DDSClass dds(DAC);
+
+	// Without sync(), the ticks start when the first channel is enabled, not at boot
+	delay(2000);
+	dds.setSampleRate(1000);
+	dds.setChannel(0, AD567X16_SAW, 1000, 2047, 2048);
+	int ticks = pollFor(dds, 10000, 50);
+	CHECK(ticks >= 10 && ticks <= 11);
+
+	// The ticks missed while loop() is busy are dropped
+	delay(50);
+	CHECK(pollFor(dds, 900, 50) == 1);
+	CHECK(pollFor(dds, 10000, 50) == 10);
+}
+
+int main()
+{
+	testSamples();
+	testTicks();
+	testPoll();
+	return hostTestResult();
+}
@@ -0,0 +1,307 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+FrameTest.cpp - Frame-level checks of the driver against the simulated AD5674(R)/AD5679(R): frame decoding, elision
+of redundant writes, broadcast writes, LDAC mask, readback and warm start.
+*/
+
+#include <AD567X16.h>
+#include <SPI.h>
+#include "AD567XSim.h"
+#include "HostTest.h"
+
+// Clocks raw bytes in a single SYNC window
+static void sendRaw(const byte *data, int length)
+{
+	SPI.beginTransaction(SPISettings(1000000, MSBFIRST, SPI_MODE1));
+	digitalWrite(10, LOW);
+	for (int i = 0; i < length; i++)
+	{
+		SPI.transfer(data[i]);
+	}
+	digitalWrite(10, HIGH);
+	SPI.endTransaction();
+}
+
+static void testDecode()
+{
+	AD567XSim sim(16, 10, 9, 8);
+	AD5679RClass DAC(10, 9, 8);
+	sim.clearCounters();
+
+	byte frame[3];
+	AD567X16Class::encodeFrame(frame, AD567X16_CMD_WRITE_INPUT_REG, 7, 0x1234);
+	sendRaw(frame, 3);
+	CHECK(sim.frames(AD567X16_CMD_WRITE_INPUT_REG) == 1);
+	CHECK(sim.inputRegister(7) == 0x1234 && sim.dacRegister(7) == 0);
+
+	// Released before the 24th bit: ignored
+	AD567X16Class::encodeFrame(frame, AD567X16_CMD_WRITE_DAC_REG, 7, 0x4321);
+	sendRaw(frame, 2);
+	CHECK(sim.incompleteFrames() == 1 && sim.dacRegister(7) == 0);
+
+	// Only the first frame of a SYNC window is executed in standalone mode
+	byte frames[6];
+	AD567X16Class::encodeFrame(frames, AD567X16_CMD_WRITE_DAC_REG, 1, 111);
+	AD567X16Class::encodeFrame(frames + 3, AD567X16_CMD_WRITE_DAC_REG, 2, 222);
+	sendRaw(frames, 6);
+	CHECK(sim.dacRegister(1) == 111 && sim.dacRegister(2) == 0);
+
+	// 12-bit model: data is left-aligned, the 4 LSBs are dropped
+	AD567XSim sim12(12, 4, 3, 2);
+	AD5674RClass DAC12(4, 3, 2);
+	DAC12.setChannel(5, (word)0xABC, true);
+	CHECK(sim12.dacRegister(5) == 0xABC0);
+	CHECK(sim12.incompleteFrames() == 0);
+}
+
+static void testElision()
+{
+	AD567XSim sim(16, 10, 9, 8);
+	AD5679RClass DAC(10, 9, 8);
+
+	DAC.setChannel(0, (word)100, true);
+	DAC.setChannel(0, (word)100, true);
+	CHECK(DAC.framesSent() == 1 && DAC.framesElided() == 1);
+	// Power-on value
+	DAC.setChannel(1, (word)0);
+	CHECK(DAC.framesElided() == 2);
+
+	// Input register written, DAC register still to be updated
+	DAC.setChannel(2, (word)500);
+	DAC.stageChannel(2, (word)500);
+	DAC.stageChannel(3, (word)7);
+	DAC.stageChannel(0, (word)100);
+	DAC.clearFrameCounters();
+	DAC.flush();
+	CHECK(DAC.framesSent() == 2 && DAC.framesElided() == 1);
+	CHECK(sim.dacRegister(0) == 100 && sim.dacRegister(2) == 500 && sim.dacRegister(3) == 7);
+
+	// Unknown shadow: nothing is elided until the registers are known again
+	DAC.invalidateShadow();
+	DAC.clearFrameCounters();
+	DAC.setChannel(0, (word)100, true);
+	CHECK(DAC.framesSent() == 1 && DAC.framesElided() == 0);
+}
+
+static void testBroadcast()
+{
+	AD567XSim sim(16, 10, 9, 8);
+	AD5679RClass DAC(10, 9, 8);
+
+	DAC.setAll((word)1234, true);
+	CHECK(sim.frames(AD567X16_CMD_WRITE_ALL_DAC) == 1);
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		CHECK(sim.dacRegister(i) == 1234);
+	}
+	DAC.setAll((word)1234, true);
+	CHECK(sim.frames(AD567X16_CMD_WRITE_ALL_DAC) == 1);
+
+	// Input registers: one broadcast for the common value plus the exceptions
+	word values[16];
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		values[i] = 500;
+	}
+	values[3] = 7;
+	values[9] = 8;
+	sim.clearCounters();
+	DAC.clearFrameCounters();
+	DAC.setChannels(values);
+	CHECK(DAC.framesSent() == 3 && sim.frames(AD567X16_CMD_WRITE_ALL_INPUT) == 1);
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		CHECK(sim.inputRegister(i) == values[i] && sim.dacRegister(i) == 1234);
+	}
+
+	// DAC registers: the broadcast still goes to the input registers, so that channel 3, already at its value, and
+	// the exceptions never output the common value. A single update frame commits the outputs that change.
+	values[3] = 1234;
+	sim.clearCounters();
+	DAC.clearFrameCounters();
+	DAC.setChannels(values, true);
+	CHECK(sim.frames(AD567X16_CMD_WRITE_ALL_DAC) == 0 && sim.frames(AD567X16_CMD_WRITE_ALL_INPUT) == 1);
+	CHECK(sim.frames(AD567X16_CMD_WRITE_DAC_REG) == 0 && sim.frames(AD567X16_CMD_UPDATE_DAC_REG) == 1);
+	CHECK(DAC.framesSent() == 4);
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		CHECK(sim.inputRegister(i) == values[i] && sim.dacRegister(i) == values[i]);
+	}
+}
+
+static void testLDACMask()
+{
+	AD567XSim sim(16, 10, 9, 8);
+	AD5679RClass DAC(10, 9, 8);
+
+	DAC.setLDACMask(0x00F0);
+	CHECK(sim.ldacMask() == 0x00F0 && DAC.LDACMask() == 0x00F0);
+	AD567XSim::clearBusCounters();
+	DAC.setLDACMask(0x00F0);
+	CHECK(AD567XSim::bus().transactions == 0);
+
+	DAC.setChannel(4, (word)40);
+	DAC.setChannel(8, (word)80);
+	DAC.updateDAC();
+	CHECK(sim.ldacPulses() == 1);
+	CHECK(sim.dacRegister(4) == 0 && sim.dacRegister(8) == 80);
+
+	DAC.setLDACMask(0);
+	DAC.updateDAC();
+	CHECK(sim.dacRegister(4) == 40);
+}
+
+static void testGroups()
+{
+	AD567XSim sim(16, 10, 9, 8);
+	AD5679RClass DAC(10, 9, 8);
+	DAC.defineGroup(0, 0x00FF);
+	DAC.defineGroup(1, 0xFF00);
+
+	word values[16];
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		values[i] = 100 + i;
+	}
+	DAC.setChannels(values);
+	DAC.commitGroup(0);
+	CHECK(sim.dacRegister(0) == 100 && sim.dacRegister(8) == 0 && sim.ldacMask() == 0xFF00);
+
+	// Further commits of the same group are bare LDAC pulses
+	AD567XSim::clearBusCounters();
+	DAC.commitGroup(0);
+	CHECK(AD567XSim::bus().transactions == 0 && AD567XSim::bus().ldac_edges == 2);
+	DAC.commitGroup(1);
+	CHECK(sim.dacRegister(8) == 108 && sim.ldacMask() == 0x00FF);
+
+	// updateDAC restores the mask set with setLDACMask (none) before pulsing LDAC
+	DAC.setChannel(9, (word)900);
+	DAC.setChannel(1, (word)901);
+	DAC.updateDAC();
+	CHECK(sim.dacRegister(9) == 900 && sim.dacRegister(1) == 901 && sim.ldacMask() == 0x0000);
+
+	// Same for the LDAC commit of setChannels, and for a mask set by the application
+	DAC.setLDACMask(0x8000);
+	DAC.commitGroup(0);
+	values[2] = 7;
+	values[10] = 8;
+	values[15] = 9;
+	CHECK(DAC.setChannels(values, false, true) == AD567X16_OK);
+	CHECK(sim.dacRegister(2) == 7 && sim.dacRegister(10) == 8 && sim.dacRegister(15) == 115);
+	CHECK(sim.ldacMask() == 0x8000 && DAC.LDACMask() == 0x8000);
+
+	// Snapshots hold the mask set by the application
+	DAC.commitGroup(1);
+	AD567X16Snapshot snapshot;
+	CHECK(DAC.snapshot(snapshot) == AD567X16_OK && snapshot.LDAC_mask == 0x8000);
+}
+
+static void testReadback()
+{
+	AD567XSim sim(12, 10, 9, 8);
+	AD5674RClass DAC(10, 9, 8);
+
+	word values[16];
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		values[i] = 100 * i + 7;
+	}
+	DAC.setChannels(values, true);
+
+	word read[16];
+	DAC.clearFrameCounters();
+	AD567XSim::clearBusCounters();
+	CHECK(DAC.readChannels(read) == AD567X16_OK);
+	CHECK(DAC.framesSent() == 17 && AD567XSim::bus().transactions == 1);
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		CHECK(read[i] == values[i]);
+	}
+	word value = 0;
+	CHECK(DAC.readChannel(5, value) == AD567X16_OK && value == 507);
+	CHECK(DAC.readChannel(16, value) == AD567X16_ERROR_CHANNEL);
+
+	// Device reset behind the driver's back: resync rewrites every channel
+	word repaired = 0;
+	sim.reset();
+	CHECK(DAC.resync(&repaired) == AD567X16_OK && repaired == 0xFFFF);
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		CHECK(sim.dacRegister(i) == values[i] << 4);
+	}
+	CHECK(DAC.resync(&repaired) == AD567X16_OK && repaired == 0);
+}
+
+static void testWarmStart()
+{
+	AD567XSim sim(12, 10, 9, 8);
+	word values[16];
+	{
+		AD5674RClass DAC(10, 9, 8);
+		for (uint8_t i = 0; i < 16; i++)
+		{
+			values[i] = 200 * i + 3;
+		}
+		DAC.setChannels(values, true);
+	}
+
+	// MCU restarted alone: the device keeps its outputs, and the driver adopts them from the readback
+	AD5674RClass DAC(10, 9, 8, AD567X16_NO_RESET);
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		CHECK(sim.dacRegister(i) == values[i] << 4);
+	}
+	word repaired = 0xFFFF;
+	CHECK(DAC.resync(&repaired) == AD567X16_OK && repaired == 0);
+	word read[16];
+	CHECK(DAC.readChannels(read) == AD567X16_OK);
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		CHECK(read[i] == values[i]);
+	}
+
+	// The adopted registers are the desired outputs of the next resync
+	sim.reset();
+	CHECK(DAC.resync(&repaired) == AD567X16_OK && repaired == 0xFFFF);
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		CHECK(sim.dacRegister(i) == values[i] << 4);
+	}
+
+	// Without a readback, nothing is elided
+	AD5674RClass cold(10, 9, 8, AD567X16_NO_RESET);
+	cold.clearFrameCounters();
+	CHECK(cold.setChannel(3, values[3], true) == AD567X16_OK && cold.framesSent() == 1);
+	CHECK(sim.dacRegister(5) == values[5] << 4);
+}
+
+int main()
+{
+	testDecode();
+	testElision();
+	testBroadcast();
+	testLDACMask();
+	testGroups();
+	testReadback();
+	testWarmStart();
+	return hostTestResult();
+}
@@ -0,0 +1,55 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+HostTest.h - Minimal checks for the host test suite.
+A failed CHECK prints its location and makes hostTestResult() non-zero; the test keeps running so that one run
+reports every failure.
+*/
+
+#ifndef AD567X16_HOST_TEST_h
+#define AD567X16_HOST_TEST_h
+
+#include <stdio.h>
+
+static int host_test_failures = 0;
+
+#define CHECK(condition)                                                              \
+	do                                                                                \
+	{                                                                                 \
+		if (!(condition))                                                             \
+		{                                                                             \
+			fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+			host_test_failures++;                                                     \
+		}                                                                             \
+	} while (0)
+
+// Exit code of the test executable
+static inline int hostTestResult()
+{
+	if (host_test_failures)
+	{
+		fprintf(stderr, "%d check(s) failed\n", host_test_failures);
+		return 1;
+	}
+	return 0;
+}
+
+#endif
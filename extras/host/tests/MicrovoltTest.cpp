@@ -0,0 +1,109 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+MicrovoltTest.cpp - Checks the integer voltage path (setChannelMillivolts/setChannelMicrovolts) against the float
+path of setChannel, and the calibration when the library is built with AD567X16_CALIBRATION.
+*/
+
+#include <AD567X16.h>
+#include <stdlib.h>
+#include "AD567XSim.h"
+#include "HostTest.h"
+
+// Largest difference, in model codes, between the integer and float paths over the whole range
+static long maxDifference(AD567X16Class &DAC, AD567XSim &sim, uint32_t Vref_uV)
+{
+	long worst = 0;
+	for (uint32_t uV = 0; uV <= Vref_uV; uV += (uV + 997 > Vref_uV && uV != Vref_uV) ? Vref_uV - uV : 997)
+	{
+		CHECK(DAC.setChannelMicrovolts(0, uV, true) == AD567X16_OK);
+		CHECK(DAC.setChannel(1, uV / 1000000.0f, true) == AD567X16_OK);
+		long difference = labs((long)(sim.dacRegister(0) >> (16 - DAC.resolution())) - (long)(sim.dacRegister(1) >> (16 - DAC.resolution())));
+		if (difference > worst)
+		{
+			worst = difference;
+		}
+		if (uV == Vref_uV)
+		{
+			break;
+		}
+	}
+	return worst;
+}
+
+static void testIntegerPath()
+{
+	AD567XSim sim12(12, 10, 9, 8);
+	AD5674RClass DAC12(10, 9, 8);
+	CHECK(maxDifference(DAC12, sim12, 2500000) <= 1);
+	CHECK(sim12.dacRegister(0) == 0xFFF0);
+
+	AD567XSim sim16(16, 7, 6, 5);
+	AD5679Class DAC16(7, 6, 5, 3.3);
+	CHECK(maxDifference(DAC16, sim16, 3300000) <= 1);
+	CHECK(sim16.dacRegister(0) == 0xFFFF);
+
+	// Millivolts are microvolts
+	DAC16.setChannelMillivolts(2, 1234, true);
+	DAC16.setChannelMicrovolts(3, 1234000, true);
+	CHECK(sim16.dacRegister(2) == sim16.dacRegister(3) && sim16.dacRegister(2) != 0);
+
+	CHECK(DAC16.setChannelMicrovolts(0, 3300001) == AD567X16_ERROR_VALUE);
+	CHECK(DAC16.setChannelMillivolts(16, 0) == AD567X16_ERROR_CHANNEL);
+	AD567XSim sim_ext(12, 4, 3, 2);
+	AD5674Class DAC_ext(4, 3, 2);
+	DAC_ext.setReference(false);
+	CHECK(DAC_ext.setChannelMillivolts(0, 1000) == AD567X16_ERROR_REFERENCE);
+}
+
+#if AD567X16_CALIBRATION
+static void testCalibration()
+{
+	AD567XSim sim(16, 10, 9, 8);
+	AD5679RClass DAC(10, 9, 8);
+
+	// +1000 ppm gain and +3 codes: 1.25 V, 32767 codes without correction
+	CHECK(DAC.setCalibration(4, 1000, 3) == AD567X16_OK);
+	DAC.setChannelMicrovolts(4, 1250000, true);
+	DAC.setChannelMicrovolts(5, 1250000, true);
+	CHECK(sim.dacRegister(5) == 32767);
+	CHECK(labs((long)sim.dacRegister(4) - (32767 + 33 + 3)) <= 1);
+
+	// Clamped to the code range
+	CHECK(DAC.setCalibration(6, 0, -10) == AD567X16_OK);
+	DAC.setChannelMicrovolts(6, 0, true);
+	CHECK(sim.dacRegister(6) == 0);
+	CHECK(DAC.setCalibration(16, 0, 0) == AD567X16_ERROR_CHANNEL);
+
+	DAC.clearCalibration();
+	DAC.setChannelMicrovolts(4, 1250000, true);
+	CHECK(sim.dacRegister(4) == 32767);
+}
+#endif
+
+int main()
+{
+	testIntegerPath();
+#if AD567X16_CALIBRATION
+	testCalibration();
+#endif
+	return hostTestResult();
+}
@@ -0,0 +1,179 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+ProgramTest.cpp - Checks the frame programs against the simulated devices: recording, playback from RAM, PROGMEM and
+a Stream, LDAC records after a group commit, and the programs compiled by csv2prog.
+*/
+
+#include <AD567X16Program.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "AD567XSim.h"
+#include "HostTest.h"
+
+// Stream over a program in memory
+class ProgramStream : public Stream
+{
+
+public:
+	ProgramStream(const byte *data, size_t length) : _data(data), _length(length) {}
+
+	size_t write(uint8_t) override { return 0; }
+	int available() override { return _length - _position; }
+	int read() override { return _position < _length ? _data[_position++] : -1; }
+	int peek() override { return _position < _length ? _data[_position] : -1; }
+
+private:
+	const byte *_data;
+	size_t _length;
+	size_t _position = 0;
+};
+
+// Same calls on every device
+static void drive(AD567X16Class &DAC)
+{
+	word values[16];
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		values[i] = 100 * i + 5;
+	}
+	DAC.setChannels(values);
+	DAC.updateDAC();
+	DAC.setChannel(4, (word)4000, true);
+	DAC.setChannel(6, (word)600);
+}
+
+static void checkSame(const AD567XSim &a, const AD567XSim &b)
+{
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		CHECK(a.inputRegister(i) == b.inputRegister(i) && a.dacRegister(i) == b.dacRegister(i));
+	}
+}
+
+static void testRecordPlay()
+{
+	AD567XSim direct(12, 10, 9, 8);
+	AD567XSim played(12, 20, 21, 22);
+	AD5674RClass DAC(10, 9, 8);
+	AD5674RClass target(20, 21, 22);
+	drive(DAC);
+
+	// Recorded calls are not sent
+	byte buffer[64 * AD567X16_FRAME_SIZE];
+	AD567X16ProgramClass program(buffer, sizeof(buffer));
+	played.clearCounters();
+	target.record(&program);
+	drive(target);
+	target.record(nullptr);
+	CHECK(program.end() && !program.overflow() && played.frames() == 0 && played.ldacPulses() == 0);
+
+	// Played in one transaction, from RAM
+	AD567XSim::clearBusCounters();
+	AD567X16PlayerClass player(target);
+	uint32_t frames = player.play(program.data(), program.length());
+	CHECK(frames == played.frames() && AD567XSim::bus().transactions == 1 && played.ldacPulses() == 1);
+	checkSame(direct, played);
+
+	// From PROGMEM and from a Stream, after a reset
+	played.reset();
+	target.invalidateShadow();
+	CHECK(player.play_P(program.data(), program.length()) == frames);
+	checkSame(direct, played);
+	played.reset();
+	target.invalidateShadow();
+	ProgramStream stream(program.data(), program.length());
+	CHECK(player.play(stream) == frames);
+	checkSame(direct, played);
+
+	// Playback stops at the end record, and a full buffer is flagged
+	byte small[2 * AD567X16_FRAME_SIZE];
+	AD567X16ProgramClass short_program(small, sizeof(small));
+	CHECK(short_program.append(AD567X16_CMD_WRITE_DAC_REG, 0, 0x1230) && short_program.end());
+	CHECK(!short_program.LDAC() && short_program.overflow());
+	CHECK(player.play(small, sizeof(small)) == 1 && played.dacRegister(0) == 0x1230);
+}
+
+static void testGroupLDAC()
+{
+	// After a group commit, an LDAC record restores the mask with a frame of the same transaction
+	AD567XSim sim(16, 10, 9, 8);
+	AD5679RClass DAC(10, 9, 8);
+	DAC.defineGroup(0, 0x000F);
+	DAC.setChannel(0, (word)1);
+	DAC.commitGroup(0);
+	CHECK(sim.ldacMask() == 0xFFF0);
+
+	byte buffer[4 * AD567X16_FRAME_SIZE];
+	AD567X16ProgramClass program(buffer, sizeof(buffer));
+	program.append(AD567X16_CMD_WRITE_INPUT_REG, 8, 800);
+	program.LDAC();
+	program.end();
+	AD567XSim::clearBusCounters();
+	AD567X16PlayerClass player(DAC);
+	CHECK(player.play(program.data(), program.length()) == 2 && AD567XSim::bus().transactions == 1);
+	CHECK(sim.ldacMask() == 0x0000 && sim.dacRegister(8) == 800 && DAC.LDACMask() == 0x0000);
+}
+
+static void testCsv2prog(const char *csv2prog)
+{
+	const char *csv = "ProgramTest.csv";
+	const char *binary = "ProgramTest.prog";
+	FILE *file = fopen(csv, "w");
+	CHECK(file != NULL);
+	fputs("delay_us,0,3\n0,100,300\n1500,,301\n2000,101,\n", file);
+	fclose(file);
+	char command[512];
+	snprintf(command, sizeof(command), "%s %s %s 2>/dev/null", csv2prog, csv, binary);
+	CHECK(system(command) == 0);
+
+	std::vector<byte> program;
+	file = fopen(binary, "rb");
+	CHECK(file != NULL);
+	for (int c; file && (c = fgetc(file)) != EOF;)
+	{
+		program.push_back((byte)c);
+	}
+	if (file)
+	{
+		fclose(file);
+	}
+	remove(csv);
+	remove(binary);
+
+	// 4 frames, 3 LDAC pulses and the delays of the lines
+	AD567XSim sim(12, 10, 9, 8);
+	AD5674RClass DAC(10, 9, 8);
+	AD567X16PlayerClass player(DAC);
+	unsigned long start = micros();
+	CHECK(player.play(program.data(), program.size()) == 4);
+	CHECK(micros() - start >= 3500 && sim.ldacPulses() == 3);
+	CHECK(sim.dacRegister(0) == 101 << 4 && sim.dacRegister(3) == 301 << 4);
+}
+
+int main()
+{
+	testRecordPlay();
+	testGroupLDAC();
+	testCsv2prog(CSV2PROG);
+	return hostTestResult();
+}
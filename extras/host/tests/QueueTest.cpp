@@ -0,0 +1,113 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+QueueTest.cpp - Checks the lock-free command queue, then stresses it with a producer thread against the draining
+consumer.
+*/
+
+#include <AD567X16Queue.h>
+#include <atomic>
+#include <thread>
+#include "AD567XSim.h"
+#include "HostTest.h"
+
+static void testQueue()
+{
+	AD567XSim sim(16, 10, 9, 8);
+	AD5679RClass DAC(10, 9, 8);
+	AD567X16QueueClass queue(DAC);
+
+	CHECK(!queue.pending() && queue.drain() == 0);
+
+	// Latest value wins, the ring keeps the other commands
+	queue.setChannel(3, 100);
+	queue.setChannel(3, 200);
+	queue.setChannel(4, 5);
+	CHECK(queue.push(AD567X16_CMD_WRITE_DAC_REG, 7, 0x1234));
+	queue.commit();
+	CHECK(queue.pending());
+	CHECK(queue.drain() == 3);
+	CHECK(sim.dacRegister(3) == 200 && sim.dacRegister(4) == 5 && sim.dacRegister(7) == 0x1234);
+	CHECK(!queue.pending());
+
+	// Full ring: the command is dropped and counted
+	for (uint8_t i = 0; i < AD567X16_QUEUE_SIZE; i++)
+	{
+		CHECK(queue.push(AD567X16_CMD_WRITE_INPUT_REG, i & 0x0F, i));
+	}
+	CHECK(!queue.push(AD567X16_CMD_WRITE_INPUT_REG, 0, 0) && queue.dropped() == 1);
+	CHECK(queue.drain() == AD567X16_QUEUE_SIZE);
+}
+
+static void testStress()
+{
+	AD567XSim sim(16, 10, 9, 8);
+	AD5679RClass DAC(10, 9, 8);
+	AD567X16QueueClass queue(DAC);
+
+	const uint32_t operations = 200000;
+	std::atomic<bool> done(false);
+
+	// Producer: increasing values on every channel, commands in the ring, commits along the way
+	std::thread producer([&]
+						 {
+		for (uint32_t k = 1; k <= operations; k++)
+		{
+			queue.setChannel(k % 16, (word)k);
+			// Retried until the consumer makes room (each failed push counts as dropped)
+			if (k % 97 == 0)
+			{
+				while (!queue.push(AD567X16_CMD_WRITE_INPUT_REG, 15, (word)k))
+				{
+				}
+			}
+			if (k % 13 == 0)
+			{
+				queue.commit();
+			}
+		}
+		done = true; });
+
+	uint32_t drains = 0;
+	while (!done)
+	{
+		queue.drain();
+		drains++;
+	}
+	producer.join();
+	queue.drain();
+
+	// The last value written to each channel reached the device (channel 15 is shared with the ring)
+	for (uint32_t channel = 0; channel < 15; channel++)
+	{
+		uint32_t last = operations - ((operations - channel) % 16);
+		CHECK(sim.inputRegister(channel) == (word)last);
+	}
+	CHECK(!queue.pending() && drains > 0);
+	CHECK(sim.incompleteFrames() == 0);
+}
+
+int main()
+{
+	testQueue();
+	testStress();
+	return hostTestResult();
+}
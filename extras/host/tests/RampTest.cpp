@@ -0,0 +1,111 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+RampTest.cpp - Checks the rate-limited ramps, driven by tick() and by poll().
+*/
+
+#include <AD567X16Ramp.h>
+#include <stdlib.h>
+#include "AD567XSim.h"
+#include "HostTest.h"
+
+static void testTicks()
+{
+	AD567XSim sim(12, 10, 9, 8);
+	AD5674RClass DAC(10, 9, 8);
+	AD567X16RampClass ramp(DAC);
+
+	// 4 codes per tick, and no limit
+	ramp.setSampleRate(1000);
+	ramp.setRate(0, 4000);
+	ramp.setTarget(0, 1000);
+	ramp.setRate(1, 0);
+	ramp.setTarget(1, 500);
+
+	for (int ticks = 1; ticks <= 250; ticks++)
+	{
+		ramp.tick();
+		CHECK((sim.dacRegister(0) >> 4) == (word)min(4 * ticks, 1000));
+		CHECK(!(ramp.completedChannels() & 0x0001) == (ticks < 250));
+	}
+	CHECK((sim.dacRegister(1) >> 4) == 500 && ramp.activeChannels() == 0);
+
+	// Idle: nothing sent
+	AD567XSim::clearBusCounters();
+	ramp.tick();
+	CHECK(AD567XSim::bus().bytes == 0 && AD567XSim::bus().ldac_edges == 0);
+}
+
+// Largest step of channel 0 between two polls, over a period of virtual time. At 1 code per tick, it is at most
+// 2 codes when a single tick ran, the position being rounded to the resolution of the model
+static long pollFor(AD567X16RampClass &ramp, AD567XSim &sim, unsigned long duration_us, unsigned long interval_us)
+{
+	long worst = 0;
+	unsigned long start = micros();
+	while (micros() - start < duration_us)
+	{
+		long before = sim.dacRegister(0) >> 4;
+		ramp.poll();
+		long step = labs((long)(sim.dacRegister(0) >> 4) - before);
+		worst = step > worst ? step : worst;
+		delayMicroseconds(interval_us);
+	}
+	return worst;
+}
+
+static void testPoll()
+{
+	AD567XSim sim(12, 10, 9, 8);
+	AD5674RClass DAC(10, 9, 8);
+	AD567X16RampClass ramp(DAC);
+	ramp.setSampleRate(1000);
+	ramp.setRate(0, 1000);
+
+	// Ramp started long after boot: no catch-up of the uptime
+	delay(2000);
+	ramp.setTarget(0, 4000);
+	CHECK(pollFor(ramp, sim, 1000000, 100) <= 2);
+	long position = sim.dacRegister(0) >> 4;
+	CHECK(position >= 990 && position <= 1001);
+
+	// loop() busy for 50 ms: the missed ticks are dropped
+	delay(50);
+	CHECK(pollFor(ramp, sim, 10000, 100) <= 2);
+	CHECK((sim.dacRegister(0) >> 4) - position <= 11);
+
+	// Same after an idle period between two ramps
+	ramp.setTarget(0, (word)(sim.dacRegister(0) >> 4));
+	while (ramp.activeChannels())
+	{
+		ramp.poll();
+		delayMicroseconds(100);
+	}
+	delay(500);
+	ramp.setTarget(0, 0);
+	CHECK(pollFor(ramp, sim, 100000, 100) <= 2);
+}
+
+int main()
+{
+	testTicks();
+	testPoll();
+	return hostTestResult();
+}
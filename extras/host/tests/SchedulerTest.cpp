@@ -0,0 +1,150 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+SchedulerTest.cpp - Checks the timestamped setpoints: preload, commit at the deadline from poll() and commit(), and
+deadlines scheduled after the preload of a later one.
+*/
+
+#include <AD567X16Scheduler.h>
+#include "AD567XSim.h"
+#include "HostTest.h"
+
+// Polls until a deadline is committed, returning the commit time relative to start
+static uint32_t pollCommit(AD567X16SchedulerClass &scheduler, uint32_t start)
+{
+	while (!scheduler.poll())
+	{
+		delayMicroseconds(10);
+	}
+	return micros() - start;
+}
+
+static void testDeadlines()
+{
+	AD567XSim sim(12, 10, 9, 8);
+	AD5674RClass DAC(10, 9, 8);
+	AD567X16SchedulerClass scheduler(DAC);
+
+	uint32_t t = micros();
+	uint8_t channels[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+	word values[8] = {10, 11, 12, 13, 14, 15, 16, 17};
+	CHECK(scheduler.schedule(t + 1000, channels, values, 8) == AD567X16_OK);
+	CHECK(scheduler.schedule(t + 250, 3, (word)300) == AD567X16_OK);
+	CHECK(scheduler.schedule(t + 5000, 9, (word)900) == AD567X16_OK);
+	CHECK(scheduler.schedule(t + 5000, 9, (word)901) == AD567X16_OK);
+	CHECK(scheduler.schedule(t, 16, (word)1) == AD567X16_ERROR_CHANNEL);
+	CHECK(scheduler.pending() == 10);
+
+	// Preloaded, with the other channels masked
+	CHECK(!scheduler.poll() && scheduler.armed() && scheduler.nextDeadline() == t + 250);
+	CHECK(sim.inputRegister(3) == 300 << 4 && sim.dacRegister(3) == 0 && sim.ldacMask() == (word)~(1 << 3));
+
+	uint32_t at = pollCommit(scheduler, t);
+	CHECK(at >= 250 && at < 260 && sim.dacRegister(3) == 300 << 4);
+
+	// Next deadline preloaded, committed from "a timer interrupt"
+	CHECK(!scheduler.poll() && scheduler.nextDeadline() == t + 1000);
+	CHECK(sim.dacRegister(3) == 300 << 4 && sim.inputRegister(3) == 13 << 4);
+	delayMicroseconds(t + 1000 - micros());
+	scheduler.commit();
+	for (uint8_t i = 0; i < 8; i++)
+	{
+		CHECK(sim.dacRegister(i) == values[i] << 4);
+	}
+	CHECK(!scheduler.poll());
+	delay(10);
+	CHECK(scheduler.poll() && sim.dacRegister(9) == 901 << 4);
+	CHECK(scheduler.stats().commits == 3 && scheduler.stats().late == 0);
+
+	// The shadow registers follow the commits
+	DAC.clearFrameCounters();
+	DAC.setChannel(9, (word)901, true);
+	CHECK(DAC.framesElided() == 1);
+
+	// Idle: updateDAC commits every channel again
+	DAC.setChannel(5, (word)500);
+	DAC.updateDAC();
+	CHECK(sim.dacRegister(5) == 500 << 4 && sim.ldacMask() == 0x0000);
+}
+
+static void testEarlierDeadline()
+{
+	AD567XSim sim(12, 10, 9, 8);
+	AD5674RClass DAC(10, 9, 8);
+	AD567X16SchedulerClass scheduler(DAC);
+
+	uint32_t t = micros();
+	CHECK(scheduler.schedule(t + 1000, 1, (word)100) == AD567X16_OK);
+	CHECK(!scheduler.poll() && scheduler.nextDeadline() == t + 1000);
+
+	// Earlier deadline scheduled after the preload: committed first, and on time
+	CHECK(scheduler.schedule(t + 250, 2, (word)200) == AD567X16_OK);
+	CHECK(!scheduler.poll() && scheduler.nextDeadline() == t + 250);
+	uint32_t at = pollCommit(scheduler, t);
+	CHECK(at >= 250 && at < 260);
+	CHECK(sim.dacRegister(2) == 200 << 4 && sim.dacRegister(1) == 0);
+
+	// Same deadline as the preloaded one: committed with it
+	CHECK(!scheduler.poll() && scheduler.nextDeadline() == t + 1000);
+	CHECK(scheduler.schedule(t + 1000, 4, (word)400) == AD567X16_OK);
+	CHECK(scheduler.schedule(t + 1000, 1, (word)101) == AD567X16_OK);
+	at = pollCommit(scheduler, t);
+	CHECK(at >= 1000 && at < 1010);
+	CHECK(sim.dacRegister(1) == 101 << 4 && sim.dacRegister(4) == 400 << 4);
+	CHECK(scheduler.pending() == 0 && !scheduler.armed() && scheduler.stats().commits == 2);
+}
+
+static void testOrder()
+{
+	AD567XSim sim(12, 10, 9, 8);
+	AD5674RClass DAC(10, 9, 8);
+	AD567X16SchedulerClass scheduler(DAC);
+
+	// Pseudo-random deadlines, committed in order
+	uint32_t t = micros();
+	for (int i = 0; i < AD567X16_SCHEDULER_EVENTS; i++)
+	{
+		CHECK(scheduler.schedule(t + ((i * 7919) % 97) * 10 + 10, i & 0x0F, (word)i) == AD567X16_OK);
+	}
+	CHECK(scheduler.schedule(t + 5000, 0, (word)0) == AD567X16_ERROR_FULL);
+
+	uint32_t last = 0;
+	while (scheduler.pending() || scheduler.armed())
+	{
+		if (scheduler.poll())
+		{
+			CHECK(scheduler.nextDeadline() - t >= last);
+			last = scheduler.nextDeadline() - t;
+		}
+		else
+		{
+			delayMicroseconds(5);
+		}
+	}
+}
+
+int main()
+{
+	testDeadlines();
+	testEarlierDeadline();
+	testOrder();
+	return hostTestResult();
+}
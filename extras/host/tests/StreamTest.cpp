@@ -0,0 +1,148 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+StreamTest.cpp - Checks the sample rings of the streaming engine against the simulated device: wrapping, underruns,
+overruns, refill callback and the timing of poll().
+*/
+
+#include <AD567X16Stream.h>
+#include "AD567XSim.h"
+#include "HostTest.h"
+
+static word samples0[8];
+static word samples1[4];
+
+struct RefillContext
+{
+	AD567X16StreamClass *stream;
+	int calls;
+	word next;
+};
+
+// Tops the ring of the channel up with increasing samples
+static void refill(uint8_t channel, uint16_t space, void *context)
+{
+	RefillContext *refill = (RefillContext *)context;
+	refill->calls++;
+	for (uint16_t i = 0; i < space; i++)
+	{
+		word sample = refill->next++;
+		CHECK(refill->stream->write(channel, &sample, 1) == 1);
+	}
+}
+
+static void testRings()
+{
+	AD567XSim sim(12, 10, 9, 8);
+	AD5674RClass DAC(10, 9, 8);
+	AD567X16StreamClass stream(DAC);
+
+	CHECK(!stream.attach(0, samples0, 6) && !stream.attach(16, samples0, 8));
+	CHECK(stream.attach(0, samples0, 8) && stream.attach(1, samples1, 4) && stream.activeChannels() == 0x0003);
+	CHECK(stream.space(0) == 7 && stream.available(0) == 0);
+
+	// Not running: tick() does nothing
+	word values[12] = {10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21};
+	CHECK(stream.write(0, values, 5) == 5 && stream.write(1, values, 3) == 3);
+	stream.tick();
+	CHECK(stream.available(0) == 5 && sim.ldacPulses() == 0);
+
+	// One sample of every channel per tick, and a single LDAC pulse
+	stream.start();
+	for (int i = 0; i < 3; i++)
+	{
+		stream.tick();
+		CHECK((sim.dacRegister(0) >> 4) == values[i] && (sim.dacRegister(1) >> 4) == values[i]);
+		CHECK(sim.ldacPulses() == (uint32_t)(i + 1));
+	}
+
+	// Channel 1 runs dry: its output is held and an underrun counted per tick
+	stream.tick();
+	CHECK((sim.dacRegister(0) >> 4) == 13 && (sim.dacRegister(1) >> 4) == 12 && stream.underruns() == 1);
+
+	// The ring of channel 0 wraps around: 1 sample left, 6 more fit, the rest is an overrun
+	CHECK(stream.write(0, values + 5, 7) == 6 && stream.overruns() == 1 && stream.space(0) == 0);
+	for (int i = 4; i < 12; i++)
+	{
+		stream.tick();
+		CHECK((sim.dacRegister(0) >> 4) == values[min(i, 10)]);
+	}
+	CHECK(stream.available(0) == 0 && stream.underruns() == 1 + 8 + 1);
+	stream.clearCounters();
+	CHECK(stream.underruns() == 0 && stream.overruns() == 0);
+
+	// The refill callback tops the rings up once enough room is free
+	RefillContext context = {&stream, 0, 100};
+	stream.detach(1);
+	stream.onRefill(refill, &context, 4);
+	stream.service();
+	CHECK(context.calls == 1 && stream.available(0) == 7);
+	stream.tick();
+	stream.service();
+	CHECK(context.calls == 1 && (sim.dacRegister(0) >> 4) == 100);
+	for (int i = 0; i < 3; i++)
+	{
+		stream.tick();
+	}
+	stream.service();
+	CHECK(context.calls == 2 && stream.available(0) == 7 && (sim.dacRegister(0) >> 4) == 103);
+	stream.stop();
+	CHECK(!stream.running() && !stream.poll());
+}
+
+// Number of ticks run by poll() over a period of virtual time
+static int pollFor(AD567X16StreamClass &stream, unsigned long duration_us, unsigned long interval_us)
+{
+	int ticks = 0;
+	unsigned long start = micros();
+	while (micros() - start < duration_us)
+	{
+		ticks += stream.poll();
+		delayMicroseconds(interval_us);
+	}
+	return ticks;
+}
+
+static void testPoll()
+{
+	AD567XSim sim(12, 10, 9, 8);
+	AD5674RClass DAC(10, 9, 8);
+	AD567X16StreamClass stream(DAC);
+	stream.attach(0, samples0, 8);
+	stream.setSampleRate(1000);
+	CHECK(stream.samplePeriod() == 1000);
+
+	stream.start();
+	int ticks = pollFor(stream, 10000, 50);
+	CHECK(ticks >= 10 && ticks <= 11);
+
+	// The ticks missed while loop() is busy are dropped
+	delay(50);
+	CHECK(pollFor(stream, 900, 50) == 1);
+	CHECK(pollFor(stream, 10000, 50) == 10);
+}
+
+int main()
+{
+	testRings();
+	testPoll();
+	return hostTestResult();
+}
@@ -0,0 +1,140 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+TransportTest.cpp - Checks the frames sent through the mock and bit-banged transports against the simulated devices.
+*/
+
+#include <AD567X16.h>
+#include <SPI.h>
+#include "AD567XSim.h"
+#include "HostTest.h"
+
+#define SCLK_PIN 13
+#define MOSI_PIN 11
+#define MISO_PIN 12
+
+static word values[16];
+
+// Same calls on every device
+static void drive(AD567X16Class &DAC)
+{
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		values[i] = 250 * i + 1;
+	}
+	DAC.setChannels(values, true);
+	DAC.setChannel(3, (word)1234, true);
+	DAC.setChannel(7, (word)4000);
+	uint8_t channels[1] = {7};
+	DAC.updateChannels(channels, 1);
+	DAC.setChannel(9, (word)99);
+}
+
+static void checkSame(const AD567XSim &a, const AD567XSim &b)
+{
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		CHECK(a.inputRegister(i) == b.inputRegister(i) && a.dacRegister(i) == b.dacRegister(i));
+	}
+}
+
+static void testMock()
+{
+	// The frames recorded by the mock, replayed on a simulated device, give the registers of a device driven
+	// through the SPI bus
+	AD567XSim direct(12, 10, 9, 8);
+	AD567XSim replayed(12, 30, 31, 32);
+	AD5674RClass DAC(10, 9, 8);
+	byte buffer[64 * AD567X16_FRAME_SIZE];
+	AD567X16MockTransport mock(buffer, sizeof(buffer));
+	AD5674RClass mocked(mock, 20, 21, 22);
+	mock.clear();
+
+	drive(DAC);
+	drive(mocked);
+	CHECK(!mock.overflow() && mock.length() % AD567X16_FRAME_SIZE == 0 && mock.transactions() > 0);
+	CHECK(mock.clock() == 10000000);
+	for (size_t i = 0; i < mock.length(); i += AD567X16_FRAME_SIZE)
+	{
+		SPI.beginTransaction(SPISettings(1000000, MSBFIRST, SPI_MODE1));
+		digitalWrite(30, LOW);
+		SPI.transfer(buffer + i, AD567X16_FRAME_SIZE);
+		digitalWrite(30, HIGH);
+		SPI.endTransaction();
+	}
+	CHECK(replayed.frames() == mock.length() / AD567X16_FRAME_SIZE && replayed.incompleteFrames() == 0);
+	checkSame(direct, replayed);
+	CHECK(replayed.dacRegister(3) == 1234 << 4 && replayed.dacRegister(7) == 4000 << 4);
+	CHECK(replayed.inputRegister(9) == 99 << 4 && replayed.dacRegister(9) == values[9] << 4);
+
+	// Nothing is received, and a full buffer is flagged
+	word value = 0xFFFF;
+	CHECK(mocked.readChannel(3, value) == AD567X16_OK && value == 0);
+	AD567X16MockTransport small(buffer, 2 * AD567X16_FRAME_SIZE);
+	AD5674RClass overflowed(small, 23, 24, 25);
+	overflowed.setChannels(values, true);
+	CHECK(small.overflow() && small.length() == 2 * AD567X16_FRAME_SIZE);
+}
+
+static void testBitBang()
+{
+	// The same calls through the bit-banged pins, and through the SPI bus
+	AD567XSim direct(16, 10, 9, 8);
+	AD567XSim banged(16, 40, 41, 42);
+	AD567XSim::attachPins(SCLK_PIN, MOSI_PIN, MISO_PIN);
+	AD5679RClass DAC(10, 9, 8);
+	AD567X16BitBangTransport transport(SCLK_PIN, MOSI_PIN, MISO_PIN);
+	AD5679RClass bitBanged(transport, 40, 41, 42);
+
+	AD567XSim::clearBusCounters();
+	drive(DAC);
+	uint32_t bytes = AD567XSim::bus().bytes;
+	AD567XSim::clearBusCounters();
+	drive(bitBanged);
+	CHECK(AD567XSim::bus().transactions == 0 && AD567XSim::bus().bytes == bytes);
+	CHECK(banged.incompleteFrames() == 0);
+	checkSame(direct, banged);
+
+	// Readback on MISO
+	word read[16];
+	CHECK(bitBanged.readChannels(read) == AD567X16_OK);
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		CHECK(read[i] == banged.dacRegister(i));
+	}
+
+	// Below 500 kHz, each SCLK edge waits half a period: 24 bits at 100 kHz take 240 us
+	bitBanged.setSPIClock(100000);
+	unsigned long start = micros();
+	bitBanged.setChannel(0, (word)5, true);
+	CHECK(micros() - start == 240 && banged.dacRegister(0) == 5);
+	bitBanged.setSPIClock(10000000);
+	start = micros();
+	bitBanged.setChannel(0, (word)6, true);
+	CHECK(micros() - start == 0 && banged.dacRegister(0) == 6);
+}
+
+int main()
+{
+	testMock();
+	testBitBang();
+	return hostTestResult();
+}
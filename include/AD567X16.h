@@ -34,15 +34,7 @@ Modified by: Daniel Melendrez (dzalf)
 Date: 2025-02-28
 
 To-do:
-- Add support for daisy-chaining
-- Add support for readback
-- Add support for LDAC mask register
-- Add support for writing to all input registers
-- Add support for writing to all DAC registers
 - Add support for software reset
-
-from dzalf:
- - Add generic Serial port pointer to constructor for verbose output on any Serial Port (other than "Serial")
 */
 
 #ifndef AD567X16_h
@@ -52,6 +44,7 @@ from dzalf:
 #include <SPI.h>
 #include <math.h>
 
+#define AD567X16_CMD_NOP B0000			   // No operation
 #define AD567X16_CMD_WRITE_INPUT_REG B0001 // Write to Input Register n
 #define AD567X16_CMD_UPDATE_DAC_REG B0010  // Update DAC Register n with Input Register n
 #define AD567X16_CMD_WRITE_DAC_REG B0011   // Write to DAC Register n
@@ -70,59 +63,400 @@ from dzalf:
 #define AD567X16_REF_INTERNAL_MESSAGE 0x0000 // Set internal reference
 #define AD567X16_REF_EXTERNAL_MESSAGE 0x0001 // Set external reference
 
+#define AD567X16_DAISY_CHAIN_MESSAGE 0x0001 // Enable the SDO pin for daisy-chaining
+
+#ifndef AD567X16_LDAC_GROUPS
+#define AD567X16_LDAC_GROUPS 4 // Number of channel groups committed by commitGroup
+#endif
+
+#define AD567X16_FRAME_SIZE 3	  // Bytes per 24-bit SPI frame
+#define AD567X16_BURST_FRAMES 16 // Frames encoded at once by burst writes
+#define AD567X16_STAGED_FRAMES 17 // Maximum number of frames sent by flush (16 channels and one update frame)
+
+#ifndef AD567X16_CLOCK_MIN
+#define AD567X16_CLOCK_MIN 1000000 // First SCLK frequency tried by characterizeSPIClock
+#endif
+
+// Hot-path statistics (getStats/resetStats). Compiled out by default, at no cost in flash, RAM or cycles.
+#ifndef AD567X16_STATS
+#define AD567X16_STATS 0
+#endif
+
+// Per-channel gain/offset correction of setChannelMillivolts/setChannelMicrovolts (setCalibration/clearCalibration).
+// Compiled out by default, its tables taking 160 bytes of RAM per device.
+#ifndef AD567X16_CALIBRATION
+#define AD567X16_CALIBRATION 0
+#endif
+
+#ifndef AD567X16_STATS_BINS
+#define AD567X16_STATS_BINS 16 // Bins of the SPI transaction latency histogram
+#endif
+
+// Levels of the messages logged by the library (setLogOutput). The messages above AD567X16_LOG_LEVEL are compiled out.
+#define AD567X16_LOG_NONE 0
+#define AD567X16_LOG_ERROR 1
+#define AD567X16_LOG_WARNING 2
+
+#ifndef AD567X16_LOG_LEVEL
+#define AD567X16_LOG_LEVEL AD567X16_LOG_WARNING
+#endif
+
+// Clock used to time the SPI transactions
+#ifndef AD567X16_STATS_CLOCK
+#if defined(ARDUINO_ARCH_ESP32)
+#define AD567X16_STATS_CLOCK() ESP.getCycleCount() // CPU cycles
+#else
+#define AD567X16_STATS_CLOCK() micros() // Microseconds
+#endif
+#endif
+
 //* Ensure compatibility with all platforms that do not use pin_size_t
 #ifdef ARDUINO_ARCH_ESP32
 typedef uint8_t pin_size_t; // Define it for ESP32
 #endif
 
-// Abstract class for all AD567X 16-channel models
+#include <AD567X16Gpio.h>
+#include <AD567X16Transport.h>
+
+// Status returned by the write functions
+enum AD567X16Status : uint8_t
+{
+	AD567X16_OK = 0,
+	AD567X16_ERROR_CHANNEL,	  // Channel out of range
+	AD567X16_ERROR_VALUE,	  // Value out of range
+	AD567X16_ERROR_REFERENCE, // Reference voltage not set
+	AD567X16_ERROR_GROUP,	  // Channel group out of range
+	AD567X16_ERROR_DEVICE,	  // Device out of range (daisy chain)
+	AD567X16_ERROR_STATE,	  // Register state unknown, or invalid snapshot
+	AD567X16_ERROR_FULL		  // No room left for the command
+};
+
+// Startup of the device by the constructors
+enum AD567X16Startup : uint8_t
+{
+	AD567X16_RESET,	   // Pulse RESET: all the outputs at zero scale, as known to the library
+	AD567X16_NO_RESET // Keep the state of the device, e.g. after a reset of the MCU alone: unknown until read back or written
+};
+
+// Description of a status, stored in flash
+const __FlashStringHelper *AD567X16StatusMessage(AD567X16Status status);
+
+// Statistics of a device, enabled with AD567X16_STATS
+struct AD567X16Stats
+{
+	uint32_t frames[16];					// Frames written, per command
+	uint32_t bytes;							// Bytes written
+	uint32_t rejected;						// Writes rejected (channel or value out of range, reference not set)
+	uint32_t LDAC_pulses;					// Pulses of the LDAC pin
+	uint32_t latency[AD567X16_STATS_BINS]; // SPI transactions by duration, bin n counting durations in [2^(n-1), 2^n) clock ticks
+};
+
+#define AD567X16_SNAPSHOT_MAGIC 0xAD67 // Marks a valid snapshot
+
+// State of a device saved by snapshot() and applied by restore()
+struct AD567X16Snapshot
+{
+	uint16_t magic;		// AD567X16_SNAPSHOT_MAGIC
+	uint8_t resolution; // Resolution of the model the snapshot was taken on
+	uint8_t reference;	// Reference setup (AD567X16_REF_INTERNAL_MESSAGE or AD567X16_REF_EXTERNAL_MESSAGE)
+	uint32_t Vref_uV;	// Reference in microvolts, 0 if unknown
+	uint32_t SPI_clock; // SCLK frequency in Hz, e.g. found by characterizeSPIClock
+	word DAC_reg[16];	// DAC registers, as 16-bit register words
+	word power[2];		// Power-down bits of channels 0-7 and 8-15
+	word LDAC_mask;
+	uint16_t checksum; // Fletcher-16 of the fields above
+};
+
+// Snapshots can be saved to the EEPROM (or its emulation in flash) on the cores providing EEPROM.h
+#ifndef AD567X16_EEPROM
+#if defined(__has_include)
+#if __has_include(<EEPROM.h>)
+#define AD567X16_EEPROM 1
+#endif
+#endif
+#endif
+#ifndef AD567X16_EEPROM
+#define AD567X16_EEPROM 0
+#endif
+
+class AD567X16ProgramClass;
+class AD567X16Class;
+
+// Bus check run by characterizeSPIClock at each clock tried, e.g. through a loopback of MOSI to MISO: true if the data
+// went through intact. The default check writes patterns to the DAC registers, so the outputs swing while it runs
+typedef bool (*AD567X16ClockCheck)(AD567X16Class &dac, void *context);
+
+// Common class for all AD567X 16-channel models
 class AD567X16Class
 {
 
 public:
-	AD567X16Class(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin);
-	AD567X16Class(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin);
-	virtual void setChannel(uint8_t channel, word value, bool DAC_update = 0, bool verbose = 0) = 0;
-	virtual void setChannel(uint8_t channel, float value, bool DAC_update = 0, bool verbose = 0) = 0;
+	AD567X16Class(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup = AD567X16_RESET);
+	AD567X16Class(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup = AD567X16_RESET);
+	AD567X16Class(AD567X16Transport &transport, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup = AD567X16_RESET);
+	AD567X16Status setChannel(uint8_t channel, word value, bool DAC_update = 0, bool verbose = 0);
+	AD567X16Status setChannel(uint8_t channel, float value, bool DAC_update = 0, bool verbose = 0);
 	void setSPIClock(uint32_t clk = 10000000);
+	uint32_t SPIClock() const { return _spiClk; }
+	AD567X16Status characterizeSPIClock(uint32_t max_clk = 50000000, uint8_t margin = 20, AD567X16ClockCheck check = nullptr, void *context = nullptr);
 	void resetRegisters(unsigned long delay_ms = 0);
 	void updateDAC(unsigned long delay_ms = 0);
-	void updateChannels(uint8_t *channels, int num_channels);
-	void powerUpDown(uint8_t *channels, bool *power_up, int num_channels);
-	void powerUpDown(uint8_t channel, bool power_up);
+	AD567X16Status updateChannels(uint8_t *channels, int num_channels);
+	AD567X16Status powerUpDown(uint8_t *channels, bool *power_up, int num_channels);
+	AD567X16Status powerUpDown(uint8_t channel, bool power_up);
+	void setLDACMask(word mask);
+	word LDACMask() const { return _LDAC_user_mask; }
+	AD567X16Status defineGroup(uint8_t group, word channels);
+	AD567X16Status commitGroup(uint8_t group, unsigned long delay_ms = 0);
+	AD567X16Status setChannels(const uint8_t *channels, const word *values, int num_channels, bool DAC_update = 0, bool LDAC_commit = 0);
+	AD567X16Status setChannels(const uint8_t *channels, const float *values, int num_channels, bool DAC_update = 0, bool LDAC_commit = 0);
+	AD567X16Status setChannels(const word *values, bool DAC_update = 0, bool LDAC_commit = 0);
+	AD567X16Status setChannels(const float *values, bool DAC_update = 0, bool LDAC_commit = 0);
+
+	AD567X16Status setAll(word value, bool DAC_update = 0);
+	AD567X16Status setAll(float value, bool DAC_update = 0, bool verbose = 0);
+
+	AD567X16Status setChannelMillivolts(uint8_t channel, uint16_t millivolts, bool DAC_update = 0, bool verbose = 0);
+	AD567X16Status setChannelMicrovolts(uint8_t channel, uint32_t microvolts, bool DAC_update = 0, bool verbose = 0);
+#if AD567X16_CALIBRATION
+	AD567X16Status setCalibration(uint8_t channel, int32_t gain_ppm, int16_t offset);
+	void clearCalibration();
+#endif
+
+	AD567X16Status stageChannel(uint8_t channel, word value);
+	AD567X16Status stageChannel(uint8_t channel, float value);
+	void flush(bool DAC_update = 1);
+	word dirtyChannels() const { return _dirty; }
+	void invalidateShadow();
+
+	uint32_t framesSent() const { return _frames_sent; }
+	uint32_t framesElided() const { return _frames_elided; }
+	void clearFrameCounters();
+
+	uint8_t resolution() const { return 16 - _shift; }
+
+	void record(AD567X16ProgramClass *program);
+
+	AD567X16Status readChannel(uint8_t channel, word &value);
+	AD567X16Status readChannels(const uint8_t *channels, word *values, int num_channels);
+	AD567X16Status readChannels(word *values);
+	AD567X16Status resync(word *repaired = nullptr);
+	void setVerify(uint8_t interval);
+	uint32_t verifyErrors() const { return _verify_errors; }
+
+	AD567X16Status snapshot(AD567X16Snapshot &snapshot);
+	AD567X16Status restore(const AD567X16Snapshot &snapshot);
+#if AD567X16_EEPROM
+	AD567X16Status saveSnapshot(int address);
+	AD567X16Status restoreSnapshot(int address);
+#endif
+
+	// Output of the error and warning messages, e.g. &Serial1 (nullptr: only the calls with verbose set log, to Serial)
+	void setLogOutput(Print *output)
+	{
+#if AD567X16_LOG_LEVEL > AD567X16_LOG_NONE
+		_log_output = output;
+#else
+		(void)output;
+#endif
+	}
+
+#if AD567X16_STATS
+	const AD567X16Stats &getStats() const { return _stats; }
+	void resetStats();
+#endif
+
+	static void encodeFrame(byte *frame, byte command, byte address, word data);
+
+	friend class AD567X16AsyncClass;
+	friend class AD567X16StreamClass;
+	friend class AD567X16DDSClass;
+	friend class AD567X16BusClass;
+	friend class AD567X16RampClass;
+	friend class AD567X16PlayerClass;
+	friend class AD567X16QueueClass;
+	friend class AD567X16SchedulerClass;
 
 protected:
-	SPIClass *_spi = nullptr;
+	SPIClass *_spi = nullptr; // Bus of the hardware SPI transport, nullptr with another transport
+
+	// Transport of the frames: the hardware SPI one below, or one given to the constructor
+	AD567X16SPITransport _spi_transport;
+	AD567X16Transport *_transport = nullptr;
 
 	pin_size_t _CS_pin;
 	pin_size_t _LDAC_pin;
 	pin_size_t _RESET_pin;
 
+	// Pins toggled through their port registers
+	AD567X16Pin _CS;
+	AD567X16Pin _LDAC;
+	AD567X16Pin _RESET;
+
 	uint32_t _spiClk;
 
 	float _Vref = 2.5;
 
+	uint8_t _shift = 0; // Left shift from the model resolution to the 16-bit register word
+
+	// Integer voltage conversion, updated when the reference or the calibration changes
+	uint32_t _Vref_uV = 2500000; // Reference in microvolts, 0 if unknown
+#if AD567X16_CALIBRATION
+	uint32_t _uV_scale[16];		 // Model codes per microvolt (Q32), including the gain correction
+	int32_t _cal_gain[16];		 // Gain correction in ppm
+	int16_t _cal_offset[16];	 // Offset correction in model codes
+#else
+	uint32_t _uV_scale; // Model codes per microvolt (Q32)
+#endif
+
+	// Shadow copies of the device registers, as 16-bit register words
+	word _input_reg[16];
+	word _DAC_reg[16];
+	word _input_known = 0x0000; // Channels whose input register shadow matches the device
+	word _DAC_known = 0x0000;	// Channels whose DAC register shadow matches the device
+
+	// LDAC mask register (channels ignoring the LDAC pin) and channel groups
+	word _LDAC_mask = 0x0000;
+	bool _LDAC_mask_known = false;
+	word _LDAC_user_mask = 0x0000; // Mask set with setLDACMask, written back by updateDAC after a group commit
+	bool _group_mask = false;	   // The LDAC mask register holds the mask of the last group committed
+	word _groups[AD567X16_LDAC_GROUPS];
+
+	// Values staged for the next flush()
+	word _staged[16];
+	word _dirty = 0x0000;
+
+	uint32_t _frames_sent = 0;
+	uint32_t _frames_elided = 0;
+
+	// Program recording the frames and LDAC pulses instead of the device, if any
+	AD567X16ProgramClass *_recorder = nullptr;
+
 	word _DAC_status_0 = 0x0000;
 	word _DAC_status_1 = 0x0000;
 
+	// Sampled verification of the DAC writes by readback: one write in _verify_interval (0: disabled)
+	uint8_t _verify_interval = 0;
+	uint8_t _verify_countdown = 0;
+	uint32_t _verify_errors = 0;
+
+	// Reference setup written to the device, and whether it and the power-down bits match the device
+	word _reference = AD567X16_REF_INTERNAL_MESSAGE;
+	bool _setup_known = false;
+
+#if AD567X16_STATS
+	AD567X16Stats _stats;
+	uint32_t _stats_start; // Clock at the start of the current SPI transaction
+#endif
+
+#if AD567X16_LOG_LEVEL > AD567X16_LOG_NONE
+	Print *_log_output = nullptr;
+
+	void logMessage(const __FlashStringHelper *level, const __FlashStringHelper *message, bool verbose);
+#endif
+
+	AD567X16Status reject(AD567X16Status status, bool verbose);
+
+	inline void countRejected()
+	{
+#if AD567X16_STATS
+		_stats.rejected++;
+#endif
+	}
+
+	void initialize(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup);
+
 	void setReference(bool internal);
 	void setReference(float Vref);
 
-	void pushChannel(uint8_t channel, word value, bool DAC_update, bool verbose);
+	AD567X16Status pushChannel(uint8_t channel, word value, bool DAC_update, bool verbose);
 
 	void writeData(byte command, byte address, word data);
+	void writeLDACMask(word mask);
+	void pulseLDAC(unsigned long delay_ms);
+
+	void updateScale();
+
+	AD567X16Status checkChannels(const uint8_t *channels, int num_channels, bool verbose = 0);
+	AD567X16Status checkVoltage(float value, bool verbose = 0);
+	word voltageToCode(float value);
+	void writeChannels(const uint8_t *channels, const word *values, int num_channels, byte command);
+	bool writeBroadcast(const uint8_t *channels, const word *values, int num_channels, byte command);
+	bool unchanged(uint8_t channel, word value, byte command);
+	void trackFrame(const byte *frame);
+	void trackLDAC();
+	int encodeStaged(byte *frames, bool DAC_update);
+	void readRegisters(const uint8_t *channels, word *values, int num_channels);
+	int sampleVerify(const byte *frames, int num_frames);
+	void verifyChannel(uint8_t channel);
+	bool checkPatterns(uint32_t reference_clk);
+
+	void beginFrames();
+	void sendFrames(byte *frames, int num_frames);
+	void transferFrames(byte *frames, int num_frames);
+	void endFrames();
 };
 
-// AD5674R: 16-channel, 12-bit DAC with internal reference
-class AD5674RClass : public AD567X16Class
+// Model-specific conversions, resolved at compile time.
+// The setChannel functions hide the generic ones of AD567X16Class, which use the resolution stored at run time.
+template <uint8_t RESOLUTION>
+class AD567X16Model : public AD567X16Class
 {
 
 public:
-	AD5674RClass(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin);
-	AD5674RClass(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin);
+	static const uint8_t SHIFT = 16 - RESOLUTION;			 // Left shift to the 16-bit register word
+	static const word FULL_SCALE = (1UL << RESOLUTION) - 1; // 4095 or 65535
+
+	AD567X16Model(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup = AD567X16_RESET) : AD567X16Class(spi, CS_pin, LDAC_pin, RESET_pin, startup)
+	{
+		_shift = SHIFT;
+		updateScale();
+	}
+
+	AD567X16Model(AD567X16Transport &transport, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup = AD567X16_RESET) : AD567X16Class(transport, CS_pin, LDAC_pin, RESET_pin, startup)
+	{
+		_shift = SHIFT;
+		updateScale();
+	}
+
+	inline AD567X16Status setChannel(uint8_t channel, word value, bool DAC_update = 0, bool verbose = 0)
+	{
+#if AD567X16_LOG_LEVEL >= AD567X16_LOG_WARNING
+		// If the value is greater than the resolution, warn the user about data loss
+		if (SHIFT && (value & ~FULL_SCALE))
+		{
+			logMessage(F("Warning: "), F("Data loss, value is greater than 12 bits"), verbose);
+		}
+#endif
+
+		return pushChannel(channel, value << SHIFT, DAC_update, verbose);
+	}
+
+	inline AD567X16Status setChannel(uint8_t channel, float value, bool DAC_update = 0, bool verbose = 0)
+	{
+		AD567X16Status status = checkVoltage(value, verbose);
+		if (status != AD567X16_OK)
+		{
+			return status;
+		}
 
-	void setChannel(uint8_t channel, word value, bool DAC_update = 0, bool verbose = 0) override;
-	void setChannel(uint8_t channel, float value, bool DAC_update = 0, bool verbose = 0) override;
+		return setChannel(channel, static_cast<word>(value / _Vref * FULL_SCALE), DAC_update, verbose);
+	}
+};
+
+template <uint8_t RESOLUTION>
+const uint8_t AD567X16Model<RESOLUTION>::SHIFT;
+template <uint8_t RESOLUTION>
+const word AD567X16Model<RESOLUTION>::FULL_SCALE;
+
+// AD5674R: 16-channel, 12-bit DAC with internal reference
+class AD5674RClass : public AD567X16Model<12>
+{
+
+public:
+	AD5674RClass(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup = AD567X16_RESET);
+	AD5674RClass(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup = AD567X16_RESET);
+	AD5674RClass(AD567X16Transport &transport, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup = AD567X16_RESET);
 };
 
 // AD5674: 16-channel, 12-bit DAC with external reference
@@ -130,24 +464,24 @@ class AD5674Class : public AD5674RClass
 {
 
 public:
-	AD5674Class(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin);
-	AD5674Class(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin);
-	AD5674Class(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, float Vref);
-	AD5674Class(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, float Vref);
+	AD5674Class(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup = AD567X16_RESET);
+	AD5674Class(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup = AD567X16_RESET);
+	AD5674Class(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, float Vref, AD567X16Startup startup = AD567X16_RESET);
+	AD5674Class(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, float Vref, AD567X16Startup startup = AD567X16_RESET);
+	AD5674Class(AD567X16Transport &transport, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup = AD567X16_RESET);
+	AD5674Class(AD567X16Transport &transport, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, float Vref, AD567X16Startup startup = AD567X16_RESET);
 
 	using AD567X16Class::setReference;
 };
 
 // AD5679R: 16-channel, 16-bit DAC with internal reference
-class AD5679RClass : public AD567X16Class
+class AD5679RClass : public AD567X16Model<16>
 {
 
 public:
-	AD5679RClass(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin);
-	AD5679RClass(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin);
-
-	void setChannel(uint8_t channel, word value, bool DAC_update = 0, bool verbose = 0) override;
-	void setChannel(uint8_t channel, float value, bool DAC_update = 0, bool verbose = 0) override;
+	AD5679RClass(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup = AD567X16_RESET);
+	AD5679RClass(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup = AD567X16_RESET);
+	AD5679RClass(AD567X16Transport &transport, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup = AD567X16_RESET);
 };
 
 // AD5679: 16-channel, 16-bit DAC with external reference
@@ -155,10 +489,12 @@ class AD5679Class : public AD5679RClass
 {
 
 public:
-	AD5679Class(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin);
-	AD5679Class(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin);
-	AD5679Class(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, float Vref);
-	AD5679Class(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, float Vref);
+	AD5679Class(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup = AD567X16_RESET);
+	AD5679Class(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup = AD567X16_RESET);
+	AD5679Class(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, float Vref, AD567X16Startup startup = AD567X16_RESET);
+	AD5679Class(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, float Vref, AD567X16Startup startup = AD567X16_RESET);
+	AD5679Class(AD567X16Transport &transport, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup = AD567X16_RESET);
+	AD5679Class(AD567X16Transport &transport, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, float Vref, AD567X16Startup startup = AD567X16_RESET);
 
 	using AD567X16Class::setReference;
 };
@@ -0,0 +1,136 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+AD567X16Async.h - Non-blocking transfers for the Analog Devices AD567X 16-channel DACs.
+Frames are encoded into a fixed-size queue and shifted out by a backend (SPI interrupt, polling, ...), which
+raises CS after each frame, pulses LDAC at the end of a batch and calls a completion callback.
+*/
+
+#ifndef AD567X16Async_h
+#define AD567X16Async_h
+
+#include <AD567X16.h>
+
+#ifndef AD567X16_ASYNC_QUEUE_SIZE
+#define AD567X16_ASYNC_QUEUE_SIZE 32 // Frames in the queue, must be a power of two
+#endif
+
+#define AD567X16_ASYNC_END_BATCH 0x01 // Last frame of a batch
+#define AD567X16_ASYNC_LDAC 0x02	  // Pulse LDAC after the frame
+
+typedef void (*AD567X16Callback)(void *context);
+
+class AD567X16AsyncClass;
+
+// Interface of the frame transmitters used by AD567X16AsyncClass
+class AD567X16AsyncBackend
+{
+
+public:
+	// Prepare the transmitter, e.g. configure the SPI peripheral and its interrupt
+	virtual void begin(AD567X16AsyncClass *engine, uint32_t clk) = 0;
+	// Start shifting a 24-bit frame, and call engine->frameDone() once it has been sent
+	virtual void startFrame(const byte *frame) = 0;
+	// Called before the first frame and after the last frame of a run of queued frames, e.g. to hold the bus meanwhile
+	virtual void beginFrames() {}
+	virtual void endFrames() {}
+};
+
+// Transmitter driven from the main loop: each poll() call sends the pending frame, if any.
+// Works with any SPIClass implementation, including the host-side shim.
+class AD567X16PolledBackend : public AD567X16AsyncBackend
+{
+
+public:
+	AD567X16PolledBackend(SPIClass &spi) : _spi(&spi) {}
+	AD567X16PolledBackend() : _spi(&SPI) {}
+
+	void begin(AD567X16AsyncClass *engine, uint32_t clk) override;
+	void startFrame(const byte *frame) override;
+	bool poll();
+
+private:
+	SPIClass *_spi;
+	AD567X16AsyncClass *_engine = nullptr;
+	SPISettings _settings;
+	const byte *volatile _frame = nullptr;
+};
+
+#if defined(ARDUINO_ARCH_MEGAAVR) && !defined(AD567X16_NO_SPI_ISR)
+// Transmitter driven by the SPI0 transfer complete interrupt of megaAVR devices (ATmega4809, ...)
+class AD567X16SPIInterruptBackend : public AD567X16AsyncBackend
+{
+
+public:
+	void begin(AD567X16AsyncClass *engine, uint32_t clk) override;
+	void startFrame(const byte *frame) override;
+	void beginFrames() override;
+	void endFrames() override;
+
+	void isr();
+
+private:
+	AD567X16AsyncClass *_engine = nullptr;
+	SPISettings _settings;
+	const byte *volatile _frame = nullptr; // Frame being sent, nullptr outside of a run of frames
+	uint8_t _index = 0;
+};
+#endif
+
+// Queue of encoded frames transmitted in the background
+class AD567X16AsyncClass
+{
+
+public:
+	AD567X16AsyncClass(AD567X16Class &dac, AD567X16AsyncBackend &backend);
+
+	void begin();
+	void onComplete(AD567X16Callback callback, void *context = nullptr);
+
+	bool write(byte command, byte address, word data);
+	bool setChannel(uint8_t channel, word value, bool DAC_update = 0);
+	bool setChannels(const uint8_t *channels, const word *values, int num_channels, bool DAC_update = 0);
+	bool commit(bool LDAC_pulse = 1);
+
+	bool busy() const { return _active; }
+	uint8_t available() const;
+
+	// Called by the backend when the current frame has been shifted out
+	void frameDone();
+
+private:
+	AD567X16Class *_dac;
+	AD567X16AsyncBackend *_backend;
+
+	AD567X16Callback _callback = nullptr;
+	void *_context = nullptr;
+
+	byte _frames[AD567X16_ASYNC_QUEUE_SIZE][AD567X16_FRAME_SIZE];
+	byte _flags[AD567X16_ASYNC_QUEUE_SIZE];
+	volatile uint8_t _head = 0; // Next slot written by the producer
+	volatile uint8_t _tail = 0; // Frame being sent, or next frame to send
+	volatile bool _active = false;
+
+	void enqueue(byte command, byte address, word data);
+	void start();
+};
+
+#endif
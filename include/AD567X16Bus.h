@@ -0,0 +1,71 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+AD567X16Bus.h - Coordinated updates of several Analog Devices AD567X 16-channel DACs sharing an SPI bus.
+Each device keeps its own CS and LDAC pins. The values staged on all the devices are written to their input registers
+in a single SPI transaction, then the LDAC pins of the devices are pulsed together, so the outputs of all the devices
+change at the same time.
+*/
+
+#ifndef AD567X16Bus_h
+#define AD567X16Bus_h
+
+#include <AD567X16.h>
+
+#ifndef AD567X16_BUS_MAX_DEVICES
+#define AD567X16_BUS_MAX_DEVICES 8 // Maximum number of devices coordinated by a bus
+#endif
+
+#if AD567X16_BUS_MAX_DEVICES > 32
+#error "AD567X16_BUS_MAX_DEVICES cannot exceed 32"
+#endif
+
+class AD567X16BusClass
+{
+
+public:
+	AD567X16BusClass(SPIClass &spi);
+	AD567X16BusClass();
+
+	AD567X16Status addDevice(AD567X16Class &dac);
+	uint8_t numDevices() const { return _num_devices; }
+
+	AD567X16Status stageChannel(uint8_t device, uint8_t channel, word value);
+	AD567X16Status stageChannel(uint8_t device, uint8_t channel, float value);
+	void commit(bool LDAC_commit = 1);
+
+	// Duration of the last commit (SPI transaction and LDAC pulses) in microseconds, and number of frames sent
+	uint32_t lastCommitTime() const { return _last_time; }
+	uint16_t lastCommitFrames() const { return _last_frames; }
+
+protected:
+	SPIClass *_spi = nullptr;
+
+	AD567X16Class *_devices[AD567X16_BUS_MAX_DEVICES];
+	uint8_t _num_devices = 0;
+
+	uint32_t _last_time = 0;
+	uint16_t _last_frames = 0;
+
+	void pulseLDAC(uint32_t updated);
+};
+
+#endif
@@ -0,0 +1,95 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+AD567X16Chain.h - Daisy-chain support for the Analog Devices AD567X 16-channel DACs.
+Several devices share the CS, LDAC and RESET pins, with the SDO pin of each device connected to the SDI pin of the next one.
+The first device of the chain (device 0) is the one connected to the MOSI pin of the Arduino.
+*/
+
+#ifndef AD567X16Chain_h
+#define AD567X16Chain_h
+
+#include <AD567X16.h>
+
+#ifndef AD567X16_CHAIN_MAX_DEVICES
+#define AD567X16_CHAIN_MAX_DEVICES 8 // Maximum number of devices in a chain
+#endif
+
+// Chain of AD567X 16-channel DACs driven from a single CS line
+class AD567X16ChainClass
+{
+
+public:
+	AD567X16ChainClass(SPIClass &spi, uint8_t num_devices, uint8_t resolution, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin);
+	AD567X16ChainClass(uint8_t num_devices, uint8_t resolution, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin);
+
+	void begin();
+	void enableDaisyChain();
+	void setSPIClock(uint32_t clk = 10000000);
+	void resetRegisters(unsigned long delay_ms = 0);
+	void updateDAC(unsigned long delay_ms = 0);
+
+	AD567X16Status setFrame(uint8_t device, byte command, byte address, word data);
+	AD567X16Status setChannel(uint8_t device, uint8_t channel, word value, bool DAC_update = 0);
+	void transfer();
+	void setChannels(const word *values, bool DAC_update = 0, bool LDAC_commit = 0);
+
+	uint8_t numDevices() const { return _num_devices; }
+
+	// Output of the error messages (nullptr: no messages)
+	void setLogOutput(Print *output)
+	{
+#if AD567X16_LOG_LEVEL > AD567X16_LOG_NONE
+		_log_output = output;
+#else
+		(void)output;
+#endif
+	}
+
+protected:
+	SPIClass *_spi = nullptr;
+
+	pin_size_t _CS_pin;
+	pin_size_t _LDAC_pin;
+	pin_size_t _RESET_pin;
+
+	AD567X16Pin _CS;
+	AD567X16Pin _LDAC;
+	AD567X16Pin _RESET;
+
+	uint32_t _spiClk;
+
+	uint8_t _num_devices;
+	uint8_t _shift; // Left shift from the model resolution to the 16-bit register word
+
+	// One frame slot per device, in the order they are shifted out (last device first)
+	byte _frames[AD567X16_CHAIN_MAX_DEVICES * AD567X16_FRAME_SIZE];
+
+#if AD567X16_LOG_LEVEL > AD567X16_LOG_NONE
+	Print *_log_output = nullptr;
+#endif
+
+	AD567X16Status reject(AD567X16Status status);
+	void clearFrames();
+	void transferFrames();
+};
+
+#endif
@@ -0,0 +1,83 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+AD567X16DDS.h - Direct digital synthesis of periodic waveforms on the Analog Devices AD567X 16-channel DACs.
+Each channel has a 32-bit phase accumulator, and its samples are computed with integer math only (sine from a
+quarter-wave lookup table in PROGMEM). On every tick, all the enabled channels are written to their input registers
+and a single LDAC pulse updates them together, so channels sharing a frequency stay phase-coherent.
+*/
+
+#ifndef AD567X16DDS_h
+#define AD567X16DDS_h
+
+#include <AD567X16.h>
+
+enum AD567X16Waveform : uint8_t
+{
+	AD567X16_SINE,
+	AD567X16_TRIANGLE,
+	AD567X16_SAW,
+	AD567X16_SQUARE
+};
+
+class AD567X16DDSClass
+{
+
+public:
+	AD567X16DDSClass(AD567X16Class &dac);
+
+	void setSampleRate(uint32_t rate);
+	void setChannel(uint8_t channel, AD567X16Waveform waveform, uint32_t frequency_mHz, word amplitude, word offset);
+	void setFrequency(uint8_t channel, uint32_t frequency_mHz);
+	void setPhase(uint8_t channel, uint16_t phase);
+	void setAmplitude(uint8_t channel, word amplitude, word offset);
+	void setWaveform(uint8_t channel, AD567X16Waveform waveform);
+
+	void enable(uint8_t channel);
+	void disable(uint8_t channel);
+	word enabledChannels() const { return _enabled; }
+
+	void sync();
+	void tick();
+	bool poll();
+
+	static int16_t sample(AD567X16Waveform waveform, uint32_t phase);
+
+private:
+	AD567X16Class *_dac;
+
+	uint32_t _rate = 1000;	 // Sample rate in Hz
+	uint32_t _period = 1000; // Sample period in microseconds
+	uint32_t _next_tick = 0;
+	word _enabled = 0x0000;
+
+	uint32_t _phase[16];		 // Phase accumulators
+	uint32_t _frequency_mHz[16]; // Frequencies, to recompute the increments when the sample rate changes
+	uint32_t _increment[16];	 // Phase increments per tick
+	uint16_t _phase_offset[16];
+	word _amplitude[16]; // Peak amplitude, as a 16-bit register word
+	word _offset[16];	 // Mid-level, as a 16-bit register word
+	AD567X16Waveform _waveform[16];
+
+	void updateIncrement(uint8_t channel);
+};
+
+#endif
@@ -0,0 +1,199 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+AD567X16Gpio.h - Fast pin toggling for the AD567X16 library.
+Each pin is resolved once to its output register(s) and bit mask, so that the CS, LDAC and RESET pins can be toggled
+without the overhead of digitalWrite in the time-critical paths. Input pins (MISO of the bit-banged transport) are
+resolved to their input register the same way.
+
+Backend selection (define before including the library, e.g. in the build flags):
+- AD567X16_FAST_GPIO 1: use the port registers on supported cores (megaAVR, AVR, ESP32, SAMD, RP2040), default
+- AD567X16_FAST_GPIO 0: always use digitalWrite and digitalRead
+*/
+
+#ifndef AD567X16Gpio_h
+#define AD567X16Gpio_h
+
+#include <Arduino.h>
+
+#ifndef AD567X16_FAST_GPIO
+#define AD567X16_FAST_GPIO 1
+#endif
+
+#if AD567X16_FAST_GPIO && defined(ARDUINO_ARCH_MEGAAVR)
+#define AD567X16_GPIO_MEGAAVR
+#elif AD567X16_FAST_GPIO && defined(ARDUINO_ARCH_AVR)
+#define AD567X16_GPIO_AVR
+#elif AD567X16_FAST_GPIO && defined(ARDUINO_ARCH_ESP32)
+#define AD567X16_GPIO_ESP32
+#include <soc/gpio_reg.h>
+#elif AD567X16_FAST_GPIO && defined(ARDUINO_ARCH_SAMD)
+#define AD567X16_GPIO_SAMD
+#elif AD567X16_FAST_GPIO && defined(ARDUINO_ARCH_RP2040)
+#define AD567X16_GPIO_RP2040
+#include <hardware/structs/sio.h>
+#endif
+
+// Output pin with a cached port register and bit mask
+class AD567X16Pin
+{
+
+public:
+	void begin(pin_size_t pin)
+	{
+		_pin = pin;
+		pinMode(pin, OUTPUT);
+
+#if defined(AD567X16_GPIO_MEGAAVR)
+		_port = digitalPinToPortStruct(pin);
+		_mask = digitalPinToBitMask(pin);
+#elif defined(AD567X16_GPIO_AVR)
+		_out = portOutputRegister(digitalPinToPort(pin));
+		_mask = digitalPinToBitMask(pin);
+#elif defined(AD567X16_GPIO_ESP32)
+#ifdef GPIO_OUT1_W1TS_REG
+		_set = (volatile uint32_t *)(pin < 32 ? GPIO_OUT_W1TS_REG : GPIO_OUT1_W1TS_REG);
+		_clr = (volatile uint32_t *)(pin < 32 ? GPIO_OUT_W1TC_REG : GPIO_OUT1_W1TC_REG);
+#else
+		// Single GPIO bank (ESP32-C3, C6, H2, ...)
+		_set = (volatile uint32_t *)GPIO_OUT_W1TS_REG;
+		_clr = (volatile uint32_t *)GPIO_OUT_W1TC_REG;
+#endif
+		_mask = 1UL << (pin & 31);
+#elif defined(AD567X16_GPIO_SAMD)
+		_set = &PORT->Group[g_APinDescription[pin].ulPort].OUTSET.reg;
+		_clr = &PORT->Group[g_APinDescription[pin].ulPort].OUTCLR.reg;
+		_mask = 1UL << g_APinDescription[pin].ulPin;
+#elif defined(AD567X16_GPIO_RP2040)
+		_set = &sio_hw->gpio_set;
+		_clr = &sio_hw->gpio_clr;
+		_mask = 1UL << pin;
+#endif
+	}
+
+	inline void high() const
+	{
+#if defined(AD567X16_GPIO_MEGAAVR)
+		_port->OUTSET = _mask;
+#elif defined(AD567X16_GPIO_AVR)
+		// Read-modify-write of the port register, which must not be interrupted
+		uint8_t sreg = SREG;
+		cli();
+		*_out |= _mask;
+		SREG = sreg;
+#elif defined(AD567X16_GPIO_ESP32) || defined(AD567X16_GPIO_SAMD) || defined(AD567X16_GPIO_RP2040)
+		*_set = _mask;
+#else
+		digitalWrite(_pin, HIGH);
+#endif
+	}
+
+	inline void low() const
+	{
+#if defined(AD567X16_GPIO_MEGAAVR)
+		_port->OUTCLR = _mask;
+#elif defined(AD567X16_GPIO_AVR)
+		uint8_t sreg = SREG;
+		cli();
+		*_out &= ~_mask;
+		SREG = sreg;
+#elif defined(AD567X16_GPIO_ESP32) || defined(AD567X16_GPIO_SAMD) || defined(AD567X16_GPIO_RP2040)
+		*_clr = _mask;
+#else
+		digitalWrite(_pin, LOW);
+#endif
+	}
+
+	pin_size_t pin() const { return _pin; }
+
+private:
+	pin_size_t _pin;
+
+#if defined(AD567X16_GPIO_MEGAAVR)
+	PORT_t *_port;
+	uint8_t _mask;
+#elif defined(AD567X16_GPIO_AVR)
+	volatile uint8_t *_out;
+	uint8_t _mask;
+#elif defined(AD567X16_GPIO_ESP32) || defined(AD567X16_GPIO_SAMD) || defined(AD567X16_GPIO_RP2040)
+	volatile uint32_t *_set;
+	volatile uint32_t *_clr;
+	uint32_t _mask;
+#endif
+};
+
+// Input pin with a cached port register and bit mask
+class AD567X16InputPin
+{
+
+public:
+	void begin(pin_size_t pin)
+	{
+		_pin = pin;
+		pinMode(pin, INPUT);
+
+#if defined(AD567X16_GPIO_MEGAAVR)
+		_in = &digitalPinToPortStruct(pin)->IN;
+		_mask = digitalPinToBitMask(pin);
+#elif defined(AD567X16_GPIO_AVR)
+		_in = portInputRegister(digitalPinToPort(pin));
+		_mask = digitalPinToBitMask(pin);
+#elif defined(AD567X16_GPIO_ESP32)
+#ifdef GPIO_IN1_REG
+		_in = (volatile uint32_t *)(pin < 32 ? GPIO_IN_REG : GPIO_IN1_REG);
+#else
+		_in = (volatile uint32_t *)GPIO_IN_REG;
+#endif
+		_mask = 1UL << (pin & 31);
+#elif defined(AD567X16_GPIO_SAMD)
+		_in = &PORT->Group[g_APinDescription[pin].ulPort].IN.reg;
+		_mask = 1UL << g_APinDescription[pin].ulPin;
+#elif defined(AD567X16_GPIO_RP2040)
+		_in = &sio_hw->gpio_in;
+		_mask = 1UL << pin;
+#endif
+	}
+
+	inline bool read() const
+	{
+#if defined(AD567X16_GPIO_MEGAAVR) || defined(AD567X16_GPIO_AVR) || defined(AD567X16_GPIO_ESP32) || \
+	defined(AD567X16_GPIO_SAMD) || defined(AD567X16_GPIO_RP2040)
+		return *_in & _mask;
+#else
+		return digitalRead(_pin) != LOW;
+#endif
+	}
+
+	pin_size_t pin() const { return _pin; }
+
+private:
+	pin_size_t _pin;
+
+#if defined(AD567X16_GPIO_MEGAAVR) || defined(AD567X16_GPIO_AVR)
+	volatile uint8_t *_in;
+	uint8_t _mask;
+#elif defined(AD567X16_GPIO_ESP32) || defined(AD567X16_GPIO_SAMD) || defined(AD567X16_GPIO_RP2040)
+	const volatile uint32_t *_in;
+	uint32_t _mask;
+#endif
+};
+
+#endif
@@ -0,0 +1,84 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+AD567X16Program.h - Precompiled frame programs for the Analog Devices AD567X 16-channel DACs.
+A program is a sequence of 3-byte records. Records with a command from 0x0 to 0xB are DAC frames, stored exactly as
+they are shifted out (command and address, then the data MSB first), so they are played without any encoding.
+The commands 0xC to 0xF, unused by the DAC, are markers executed by the player:
+- AD567X16_PROG_LDAC: pulse LDAC
+- AD567X16_PROG_DELAY_US: wait for data microseconds
+- AD567X16_PROG_DELAY_MS: wait for data milliseconds
+- AD567X16_PROG_END: end of the program
+*/
+
+#ifndef AD567X16Program_h
+#define AD567X16Program_h
+
+#include <AD567X16.h>
+
+#define AD567X16_PROG_LDAC B1100	 // Pulse LDAC
+#define AD567X16_PROG_DELAY_US B1101 // Wait for data microseconds
+#define AD567X16_PROG_DELAY_MS B1110 // Wait for data milliseconds
+#define AD567X16_PROG_END B1111		 // End of the program
+
+// Program built in a RAM buffer, by hand or by recording the calls made on a device (AD567X16Class::record)
+class AD567X16ProgramClass
+{
+
+public:
+	AD567X16ProgramClass(byte *buffer, size_t size);
+
+	void clear();
+	bool append(byte command, byte address, word data);
+	bool append(const byte *frames, int num_frames);
+	bool LDAC();
+	bool delayMicros(uint32_t us);
+	bool end();
+
+	const byte *data() const { return _buffer; }
+	size_t length() const { return _length; }
+	bool overflow() const { return _overflow; }
+
+private:
+	byte *_buffer;
+	size_t _size;
+	size_t _length = 0;
+	bool _overflow = false;
+};
+
+// Plays programs from RAM, PROGMEM or a Stream (e.g. a file)
+class AD567X16PlayerClass
+{
+
+public:
+	AD567X16PlayerClass(AD567X16Class &dac);
+
+	uint32_t play(const byte *program, size_t length);
+	uint32_t play_P(const byte *program, size_t length);
+	uint32_t play(Stream &stream);
+
+private:
+	AD567X16Class *_dac;
+
+	bool execute(byte *record, uint32_t &frames);
+};
+
+#endif
@@ -0,0 +1,87 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+AD567X16Queue.h - Lock-free command queue for the Analog Devices AD567X 16-channel DACs.
+A producer context (an interrupt, or another task or core) queues commands without blocking and without touching the
+SPI bus, and the context owning the device sends them with drain(). Channel values go to one slot per channel, where
+the latest value wins, so the queue stays bounded however fast the producer writes; other commands are queued as
+encoded frames in a single-producer/single-consumer ring.
+Each queue supports one producer and one consumer. Several producers can use one queue each, drained by the same
+consumer.
+*/
+
+#ifndef AD567X16Queue_h
+#define AD567X16Queue_h
+
+#include <AD567X16.h>
+
+#ifndef AD567X16_QUEUE_SIZE
+#define AD567X16_QUEUE_SIZE 16 // Frames in the ring, a power of two up to 128
+#endif
+
+#if (AD567X16_QUEUE_SIZE & (AD567X16_QUEUE_SIZE - 1)) || AD567X16_QUEUE_SIZE > 128
+#error "AD567X16_QUEUE_SIZE must be a power of two up to 128"
+#endif
+
+// The 8-bit AVR cores have no atomic read-modify-write instructions: short critical sections are used instead
+#if defined(ARDUINO_ARCH_AVR) || defined(ARDUINO_ARCH_MEGAAVR)
+#define AD567X16_QUEUE_CRITICAL_SECTIONS
+#endif
+
+class AD567X16QueueClass
+{
+
+public:
+	AD567X16QueueClass(AD567X16Class &dac);
+
+	// Producer
+	bool setChannel(uint8_t channel, word value);
+	bool push(byte command, byte address, word data);
+	void commit();
+	uint16_t dropped() const { return _dropped; }
+
+	// Consumer
+	uint16_t drain();
+	bool pending() const;
+
+private:
+	AD567X16Class *_dac;
+
+	// Ring of encoded frames, the head being written by the producer only and the tail by the consumer only
+	byte _frames[AD567X16_QUEUE_SIZE][AD567X16_FRAME_SIZE];
+	volatile uint8_t _head = 0;
+	volatile uint8_t _tail = 0;
+	uint16_t _dropped = 0;
+
+	// Latest value of each channel, each slot guarded by a sequence number that is odd while the slot is written
+	volatile word _slots[16];
+	volatile uint8_t _sequence[16];
+	volatile word _dirty = 0x0000; // Channels with a new value
+	volatile word _commit = 0x0000;
+
+	static uint8_t loadAcquire(const volatile uint8_t *value);
+	static void storeRelease(volatile uint8_t *value, uint8_t new_value);
+	static word exchange(volatile word *value, word new_value);
+	static void fetchOr(volatile word *value, word bits);
+	static void fence();
+};
+
+#endif
@@ -0,0 +1,80 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+AD567X16Ramp.h - Slew-rate-limited ramps on the Analog Devices AD567X 16-channel DACs.
+Each channel moves from its current output to its target at a maximum rate, with a linear or S-curve profile. Ramps
+are advanced by tick() with integer math only, and only the channels whose output code changes are written, followed
+by a single LDAC pulse.
+*/
+
+#ifndef AD567X16Ramp_h
+#define AD567X16Ramp_h
+
+#include <AD567X16.h>
+
+enum AD567X16RampProfile : uint8_t
+{
+	AD567X16_LINEAR, // Constant rate
+	AD567X16_SCURVE	 // Smooth start and stop (smoothstep), with the maximum rate reached halfway
+};
+
+class AD567X16RampClass
+{
+
+public:
+	AD567X16RampClass(AD567X16Class &dac);
+
+	void setSampleRate(uint32_t rate);
+	AD567X16Status setRate(uint8_t channel, uint32_t rate);
+	AD567X16Status setProfile(uint8_t channel, AD567X16RampProfile profile);
+	AD567X16Status setTarget(uint8_t channel, word target);
+	void stop(uint8_t channel);
+
+	word position(uint8_t channel) const { return _position[channel & 0x0F] >> _dac->_shift; }
+	word activeChannels() const { return _active; }
+	word completedChannels() const { return _completed; }
+
+	void tick();
+	bool poll();
+
+private:
+	AD567X16Class *_dac;
+
+	uint32_t _rate = 1000;	 // Tick rate in Hz
+	uint32_t _period = 1000; // Tick period in microseconds
+	uint32_t _next_tick = 0;
+
+	word _active = 0x0000;	  // Channels ramping
+	word _completed = 0x0000; // Channels that reached their target
+	word _known = 0x0000;	  // Channels whose position is known
+
+	uint32_t _slew[16];	   // Maximum rate, in model codes per second (0: no limit)
+	uint32_t _progress[16]; // Progress of the current ramp, in Q32
+	uint32_t _step[16];	   // Progress per tick, in Q32
+	word _start[16];	   // Start and target of the current ramp, as 16-bit register words
+	word _target[16];
+	word _position[16]; // Last output written, as a 16-bit register word
+	AD567X16RampProfile _profile[16];
+
+	void startRamp(uint8_t channel);
+};
+
+#endif
@@ -0,0 +1,103 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+AD567X16Scheduler.h - Timestamped setpoints on the Analog Devices AD567X 16-channel DACs.
+Setpoints are kept in a min-heap ordered by deadline. The setpoints of the next deadline are written to the input
+registers ahead of time, with the LDAC mask set to the channels concerned, so that committing them at the deadline is
+a bare LDAC pulse, fired by poll() or from a timer interrupt with commit().
+*/
+
+#ifndef AD567X16Scheduler_h
+#define AD567X16Scheduler_h
+
+#include <AD567X16.h>
+
+#ifndef AD567X16_SCHEDULER_EVENTS
+#define AD567X16_SCHEDULER_EVENTS 32 // Setpoints waiting in the scheduler
+#endif
+
+#ifndef AD567X16_SCHEDULER_SPIN_US
+#define AD567X16_SCHEDULER_SPIN_US 100 // poll() waits for the deadlines closer than this, to commit them on time
+#endif
+
+// Timing of the commits, in microseconds
+struct AD567X16SchedulerStats
+{
+	uint32_t commits;		 // Deadlines committed
+	uint32_t late;			 // Deadlines whose setpoints were only written after the deadline
+	uint32_t max_lateness;	 // Largest delay of an LDAC pulse after its deadline
+	uint32_t total_lateness; // Sum of the delays, for the mean
+};
+
+class AD567X16SchedulerClass
+{
+
+public:
+	AD567X16SchedulerClass(AD567X16Class &dac);
+
+	AD567X16Status schedule(uint32_t time, uint8_t channel, word value);
+	AD567X16Status schedule(uint32_t time, uint8_t channel, float value);
+	AD567X16Status schedule(uint32_t time, const uint8_t *channels, const word *values, int num_channels);
+	void clear();
+
+	uint8_t pending() const { return _count; }
+	bool armed() const { return _armed; }
+	uint32_t nextDeadline() const { return _deadline; }
+
+	bool poll();
+	void commit();
+
+	const AD567X16SchedulerStats &stats() const { return _stats; }
+	void resetStats();
+
+private:
+	struct Event
+	{
+		uint32_t time;	 // Deadline, in micros()
+		word value;		 // Value, in the model resolution
+		uint8_t channel;
+	};
+
+	AD567X16Class *_dac;
+
+	Event _events[AD567X16_SCHEDULER_EVENTS]; // Min-heap on the deadlines
+	uint8_t _count = 0;
+
+	// Deadline preloaded in the input registers, and commit fired by commit()
+	volatile bool _armed = false;
+	volatile bool _fired = false;
+	volatile uint32_t _fired_at = 0;
+	uint32_t _deadline = 0;
+	word _group = 0x0000; // Channels preloaded for the deadline
+
+	AD567X16SchedulerStats _stats;
+
+	// Deadline order, valid across the wrap of micros() for deadlines less than 35 minutes apart
+	static bool before(uint32_t a, uint32_t b) { return (int32_t)(a - b) < 0; }
+
+	AD567X16Status insert(uint32_t time, uint8_t channel, word value);
+	void remove();
+	bool disarm(uint32_t time, int num_channels);
+	void arm();
+	void finish();
+};
+
+#endif
@@ -0,0 +1,98 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+AD567X16Stream.h - Timer-driven waveform streaming for the Analog Devices AD567X 16-channel DACs.
+Each streamed channel reads its samples from a ring buffer. On every tick, the next sample of every active channel is
+written to its input register and a single LDAC pulse updates all the outputs at the same time.
+*/
+
+#ifndef AD567X16Stream_h
+#define AD567X16Stream_h
+
+#include <AD567X16.h>
+
+// Called when a channel has room for at least the refill threshold
+typedef void (*AD567X16RefillCallback)(uint8_t channel, uint16_t space, void *context);
+
+// Sample ring buffer of one channel
+struct AD567X16Ring
+{
+	word *buffer;
+	uint16_t mask; // Size - 1, the size being a power of two
+	volatile uint16_t head;
+	volatile uint16_t tail;
+};
+
+class AD567X16StreamClass
+{
+
+public:
+	AD567X16StreamClass(AD567X16Class &dac);
+
+	bool attach(uint8_t channel, word *buffer, uint16_t size);
+	void detach(uint8_t channel);
+	word activeChannels() const { return _active; }
+
+	void setSampleRate(uint32_t rate);
+	uint32_t samplePeriod() const { return _period; }
+	void onRefill(AD567X16RefillCallback callback, void *context = nullptr, uint16_t threshold = 1);
+
+	uint16_t write(uint8_t channel, const word *samples, uint16_t count);
+	uint16_t available(uint8_t channel) const;
+	uint16_t space(uint8_t channel) const;
+
+	void start();
+	void stop();
+	bool running() const { return _running; }
+
+	void tick();
+	bool poll();
+	void service();
+
+	uint32_t underruns() const { return _underruns; }
+	uint32_t overruns() const { return _overruns; }
+	void clearCounters();
+
+#if defined(ARDUINO_ARCH_MEGAAVR) && !defined(AD567X16_NO_STREAM_TIMER)
+	bool beginTimer();
+	void endTimer();
+#endif
+
+private:
+	AD567X16Class *_dac;
+
+	AD567X16Ring _rings[16];
+	word _active = 0x0000;
+
+	uint32_t _rate = 1000;	 // Sample rate in Hz
+	uint32_t _period = 1000; // Sample period in microseconds
+	uint32_t _next_tick = 0;
+	volatile bool _running = false;
+
+	AD567X16RefillCallback _refill = nullptr;
+	void *_context = nullptr;
+	uint16_t _threshold = 1;
+
+	volatile uint32_t _underruns = 0;
+	volatile uint32_t _overruns = 0;
+};
+
+#endif
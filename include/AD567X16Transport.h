@@ -0,0 +1,119 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+AD567X16Transport.h - Frame transports for the Analog Devices AD567X 16-channel DACs.
+A transport shifts out the 24-bit frames of a device in SPI mode 1 (MSB first), with CS low during each frame:
+- AD567X16SPITransport: hardware SPI (SPIClass), the default of the devices
+- AD567X16BitBangTransport: any two (or three) pins, toggled through their port registers
+- AD567X16MockTransport: records the frames in a buffer, without any I/O, for tests
+*/
+
+#ifndef AD567X16Transport_h
+#define AD567X16Transport_h
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <AD567X16Gpio.h>
+
+#define AD567X16_NO_PIN 0xFF // Unconnected pin
+
+// Interface of the frame transports used by AD567X16Class
+class AD567X16Transport
+{
+
+public:
+	// Take the bus for a sequence of frames, at clk Hz
+	virtual void begin(uint32_t clk) = 0;
+	// Shift out num_frames frames, toggling CS around each of them. The buffer is overwritten with the data received.
+	virtual void transferFrames(byte *frames, int num_frames, const AD567X16Pin &CS) = 0;
+	// Release the bus
+	virtual void end() = 0;
+};
+
+// Hardware SPI, with 24-bit transfers where the core provides them
+class AD567X16SPITransport : public AD567X16Transport
+{
+
+public:
+	AD567X16SPITransport(SPIClass &spi) : _spi(&spi) {}
+	AD567X16SPITransport() : _spi(&SPI) {}
+
+	void begin(uint32_t clk) override;
+	void transferFrames(byte *frames, int num_frames, const AD567X16Pin &CS) override;
+	void end() override;
+
+	SPIClass *spi() const { return _spi; }
+
+private:
+	SPIClass *_spi;
+};
+
+// Bit-banged SPI mode 1, for boards whose hardware SPI is busy or on other pins.
+// The bits are shifted as fast as the port writes allow, or slower for the clocks below 500 kHz, which get a delay of
+// half a period (in whole microseconds) on each edge.
+class AD567X16BitBangTransport : public AD567X16Transport
+{
+
+public:
+	AD567X16BitBangTransport(pin_size_t SCLK_pin, pin_size_t MOSI_pin, pin_size_t MISO_pin = AD567X16_NO_PIN);
+
+	void begin(uint32_t clk) override;
+	void transferFrames(byte *frames, int num_frames, const AD567X16Pin &CS) override;
+	void end() override {}
+
+private:
+	AD567X16Pin _SCLK;
+	AD567X16Pin _MOSI;
+	AD567X16InputPin _MISO;
+	bool _read;
+	uint16_t _half_period_us = 0; // Delay on each SCLK edge, 0 above 500 kHz
+
+	byte transferByte(byte data);
+};
+
+// Transport recording the frames sent, for host tests. The data received is all zeros.
+class AD567X16MockTransport : public AD567X16Transport
+{
+
+public:
+	AD567X16MockTransport(byte *buffer, size_t size) : _buffer(buffer), _size(size) {}
+
+	void begin(uint32_t clk) override;
+	void transferFrames(byte *frames, int num_frames, const AD567X16Pin &CS) override;
+	void end() override {}
+
+	const byte *data() const { return _buffer; }
+	size_t length() const { return _length; }
+	bool overflow() const { return _overflow; }
+	uint32_t transactions() const { return _transactions; }
+	uint32_t clock() const { return _clk; } // Clock of the last transaction
+	void clear();
+
+private:
+	byte *_buffer;
+	size_t _size;
+	size_t _length = 0;
+	bool _overflow = false;
+	uint32_t _transactions = 0;
+	uint32_t _clk = 0;
+};
+
+#endif
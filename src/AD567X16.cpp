@@ -35,75 +35,125 @@ Date: 2025-02-28
 
 
 To-do:
-- Add support for daisy-chaining
-- Add support for readback
-- Add support for LDAC mask register
-- Add support for writing to all input registers
-- Add support for writing to all DAC registers
 - Add support for software reset
 */
 
 // #include <Arduino.h>
 // #include <SPI.h>
 #include <AD567X16.h>
+#include <AD567X16Program.h>
+#include <stddef.h>
 // #include <math.h>
+#if AD567X16_EEPROM
+#include <EEPROM.h>
+#endif
 
-AD567X16Class::AD567X16Class(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin)
+// Channel list used by the all-channel overloads
+static const uint8_t AD567X16_ALL_CHANNELS[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+
+AD567X16Class::AD567X16Class(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup) : _spi_transport(spi)
 {
 	_spi = &spi;
+	_transport = &_spi_transport;
+	initialize(CS_pin, LDAC_pin, RESET_pin, startup);
+}
+
+AD567X16Class::AD567X16Class(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup) : AD567X16Class(SPI, CS_pin, LDAC_pin, RESET_pin, startup) {}
+
+AD567X16Class::AD567X16Class(AD567X16Transport &transport, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup)
+{
+	_transport = &transport;
+	initialize(CS_pin, LDAC_pin, RESET_pin, startup);
+}
+
+void AD567X16Class::initialize(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup)
+{
 	_CS_pin = CS_pin;
 	_LDAC_pin = LDAC_pin;
 	_RESET_pin = RESET_pin;
 
-	pinMode(_CS_pin, OUTPUT);
-	pinMode(_LDAC_pin, OUTPUT);
-	pinMode(_RESET_pin, OUTPUT);
+	_CS.begin(_CS_pin);
+	_LDAC.begin(_LDAC_pin);
+	_RESET.begin(_RESET_pin);
 
 	// SPI settings
 	this->setSPIClock();
 	// SPI.setDataMode(SPI_MODE1);
 	// SPI.setBitOrder(MSBFIRST);
 
-	digitalWrite(_CS_pin, HIGH);
-	digitalWrite(_LDAC_pin, HIGH);
-	digitalWrite(_RESET_pin, HIGH);
+	_CS.high();
+	_LDAC.high();
+	_RESET.high();
 
-	resetRegisters();
-}
+	for (uint8_t i = 0; i < AD567X16_LDAC_GROUPS; i++)
+	{
+		_groups[i] = 0x0000;
+	}
 
-AD567X16Class::AD567X16Class(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin) : AD567X16Class(SPI, CS_pin, LDAC_pin, RESET_pin) {}
+	if (startup == AD567X16_NO_RESET)
+	{
+		// The device keeps its outputs: nothing is elided until its registers are read back (resync), restored or
+		// written
+		for (uint8_t i = 0; i < 16; i++)
+		{
+			_input_reg[i] = 0x0000;
+			_DAC_reg[i] = 0x0000;
+		}
+		_LDAC_mask = 0x0000;
+		_LDAC_user_mask = 0x0000;
+		_group_mask = false;
+		_DAC_status_0 = 0x0000;
+		_DAC_status_1 = 0x0000;
+		_reference = AD567X16_REF_INTERNAL_MESSAGE;
+		invalidateShadow();
+	}
+	else
+	{
+		resetRegisters();
+	}
+#if AD567X16_CALIBRATION
+	clearCalibration();
+#else
+	updateScale();
+#endif
+#if AD567X16_STATS
+	resetStats();
+#endif
+}
 
 //* AD5674R: 16-channel, 12-bit DAC with internal reference
-AD5674RClass::AD5674RClass(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin) : AD567X16Class(SPI, CS_pin, LDAC_pin, RESET_pin) {}
-AD5674RClass::AD5674RClass(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin) : AD567X16Class(CS_pin, LDAC_pin, RESET_pin) {}
+AD5674RClass::AD5674RClass(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup) : AD567X16Model<12>(spi, CS_pin, LDAC_pin, RESET_pin, startup) {}
+AD5674RClass::AD5674RClass(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup) : AD567X16Model<12>(SPI, CS_pin, LDAC_pin, RESET_pin, startup) {}
+AD5674RClass::AD5674RClass(AD567X16Transport &transport, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup) : AD567X16Model<12>(transport, CS_pin, LDAC_pin, RESET_pin, startup) {}
 
 //* AD5674: 16-channel, 12-bit DAC with external reference
-AD5674Class::AD5674Class(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin) : AD5674RClass(SPI, CS_pin, LDAC_pin, RESET_pin) {}
-AD5674Class::AD5674Class(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin) : AD5674RClass(CS_pin, LDAC_pin, RESET_pin) {}
-AD5674Class::AD5674Class(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, float Vref) : AD5674RClass(SPI, CS_pin, LDAC_pin, RESET_pin) { setReference(Vref); }
-AD5674Class::AD5674Class(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, float Vref) : AD5674RClass(CS_pin, LDAC_pin, RESET_pin) { setReference(Vref); }
+AD5674Class::AD5674Class(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup) : AD5674RClass(spi, CS_pin, LDAC_pin, RESET_pin, startup) {}
+AD5674Class::AD5674Class(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup) : AD5674RClass(CS_pin, LDAC_pin, RESET_pin, startup) {}
+AD5674Class::AD5674Class(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, float Vref, AD567X16Startup startup) : AD5674RClass(spi, CS_pin, LDAC_pin, RESET_pin, startup) { setReference(Vref); }
+AD5674Class::AD5674Class(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, float Vref, AD567X16Startup startup) : AD5674RClass(CS_pin, LDAC_pin, RESET_pin, startup) { setReference(Vref); }
+AD5674Class::AD5674Class(AD567X16Transport &transport, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup) : AD5674RClass(transport, CS_pin, LDAC_pin, RESET_pin, startup) {}
+AD5674Class::AD5674Class(AD567X16Transport &transport, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, float Vref, AD567X16Startup startup) : AD5674RClass(transport, CS_pin, LDAC_pin, RESET_pin, startup) { setReference(Vref); }
 
 //* AD5679R: 16-channel, 16-bit DAC with internal reference
-AD5679RClass::AD5679RClass(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin) : AD567X16Class(SPI, CS_pin, LDAC_pin, RESET_pin) {}
-AD5679RClass::AD5679RClass(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin) : AD567X16Class(CS_pin, LDAC_pin, RESET_pin) {}
+AD5679RClass::AD5679RClass(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup) : AD567X16Model<16>(spi, CS_pin, LDAC_pin, RESET_pin, startup) {}
+AD5679RClass::AD5679RClass(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup) : AD567X16Model<16>(SPI, CS_pin, LDAC_pin, RESET_pin, startup) {}
+AD5679RClass::AD5679RClass(AD567X16Transport &transport, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup) : AD567X16Model<16>(transport, CS_pin, LDAC_pin, RESET_pin, startup) {}
 
 //* AD5679: 16-channel, 16-bit DAC with external reference
-AD5679Class::AD5679Class(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin) : AD5679RClass(SPI, CS_pin, LDAC_pin, RESET_pin) {}
-AD5679Class::AD5679Class(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin) : AD5679RClass(CS_pin, LDAC_pin, RESET_pin) {}
-AD5679Class::AD5679Class(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, float Vref) : AD5679RClass(SPI, CS_pin, LDAC_pin, RESET_pin) { setReference(Vref); }
-AD5679Class::AD5679Class(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, float Vref) : AD5679RClass(CS_pin, LDAC_pin, RESET_pin) { setReference(Vref); }
+AD5679Class::AD5679Class(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup) : AD5679RClass(spi, CS_pin, LDAC_pin, RESET_pin, startup) {}
+AD5679Class::AD5679Class(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup) : AD5679RClass(CS_pin, LDAC_pin, RESET_pin, startup) {}
+AD5679Class::AD5679Class(SPIClass &spi, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, float Vref, AD567X16Startup startup) : AD5679RClass(spi, CS_pin, LDAC_pin, RESET_pin, startup) { setReference(Vref); }
+AD5679Class::AD5679Class(pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, float Vref, AD567X16Startup startup) : AD5679RClass(CS_pin, LDAC_pin, RESET_pin, startup) { setReference(Vref); }
+AD5679Class::AD5679Class(AD567X16Transport &transport, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, AD567X16Startup startup) : AD5679RClass(transport, CS_pin, LDAC_pin, RESET_pin, startup) {}
+AD5679Class::AD5679Class(AD567X16Transport &transport, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin, float Vref, AD567X16Startup startup) : AD5679RClass(transport, CS_pin, LDAC_pin, RESET_pin, startup) { setReference(Vref); }
 
-void AD567X16Class::pushChannel(uint8_t channel, word value, bool DAC_update, bool verbose)
+AD567X16Status AD567X16Class::pushChannel(uint8_t channel, word value, bool DAC_update, bool verbose)
 {
 
 	// Check if the channel is within the valid range
-	if (channel < 0 || channel > 15)
+	if (channel > 15)
 	{
-		if (verbose)
-		{
-			Serial.println("Error: Channel out of range");
-		}
-		return;
+		return reject(AD567X16_ERROR_CHANNEL, verbose);
 	}
 
 	byte command;
@@ -117,93 +167,164 @@ void AD567X16Class::pushChannel(uint8_t channel, word value, bool DAC_update, bo
 		command = AD567X16_CMD_WRITE_INPUT_REG;
 	}
 
+	// Skip the frame if the registers already hold this value
+	if (unchanged(channel, value, command))
+	{
+		_frames_elided++;
+		return AD567X16_OK;
+	}
+
 	writeData(command, channel, value);
+	return AD567X16_OK;
 }
 
-void AD5674RClass::setChannel(uint8_t channel, word value, bool DAC_update, bool verbose)
+AD567X16Status AD567X16Class::setChannel(uint8_t channel, word value, bool DAC_update, bool verbose)
 {
+	// Generic version, using the resolution of the model stored at run time
+	return pushChannel(channel, value << _shift, DAC_update, verbose);
+}
 
-	// If the value is greater than 12 bits, warn the user about data loss
-	if (verbose && !(value & 0xF000))
+AD567X16Status AD567X16Class::setChannel(uint8_t channel, float value, bool DAC_update, bool verbose)
+{
+	AD567X16Status status = checkVoltage(value, verbose);
+	if (status != AD567X16_OK)
 	{
-		Serial.println("Warning: Data loss, value is greater than 12 bits");
+		return status;
 	}
 
-	// Send the 12-bit data to the DAC
-	pushChannel(channel, value << 4, DAC_update, verbose);
+	return setChannel(channel, voltageToCode(value), DAC_update, verbose);
 }
 
-void AD5679RClass::setChannel(uint8_t channel, word value, bool DAC_update, bool verbose)
+void AD567X16Class::setSPIClock(uint32_t clock)
 {
-
-	// Send the 16-bit data to the DAC
-	pushChannel(channel, value, DAC_update, verbose);
+	_spiClk = clock;
 }
 
-void AD5674RClass::setChannel(uint8_t channel, float value, bool DAC_update, bool verbose)
+AD567X16Status AD567X16Class::characterizeSPIClock(uint32_t max_clk, uint8_t margin, AD567X16ClockCheck check, void *context)
 {
+	if (_recorder)
+	{
+		return reject(AD567X16_ERROR_STATE, 0);
+	}
 
-	if (isnan(_Vref))
+	// Registers overwritten by the test patterns, written back at the end
+	word input_reg[16];
+	word DAC_reg[16];
+	word input_known = _input_known;
+	word DAC_known = _DAC_known;
+	memcpy(input_reg, _input_reg, sizeof(input_reg));
+	memcpy(DAC_reg, _DAC_reg, sizeof(DAC_reg));
+
+	uint8_t verify_interval = _verify_interval;
+	_verify_interval = 0;
+	uint32_t previous_clk = _spiClk;
+
+	// Step the clock up by 25 % until the bus fails, the first clock serving as reference once it passed
+	uint32_t best_clk = 0;
+	uint32_t reference_clk = min((uint32_t)AD567X16_CLOCK_MIN, max_clk);
+	uint32_t clk = reference_clk;
+	while (clk)
 	{
-		if (verbose)
+		_spiClk = clk;
+		if (!(check ? check(*this, context) : checkPatterns(reference_clk)))
 		{
-			Serial.println("Error: Reference voltage not set");
+			break;
 		}
-		return;
+		best_clk = clk;
+		if (clk >= max_clk)
+		{
+			break;
+		}
+		clk = min(clk + clk / 4, max_clk);
 	}
 
-	if (value < 0 || value > _Vref)
+	// Write the registers back at the reference clock, the DAC register first since it also writes the input register
+	_spiClk = best_clk ? reference_clk : previous_clk;
+	byte frames[2 * AD567X16_FRAME_SIZE];
+	beginFrames();
+	for (uint8_t i = 0; i < 16; i++)
 	{
-		if (verbose)
+		word mask = 1 << i;
+		int count = 0;
+		if (DAC_known & mask)
 		{
-			Serial.println("Error: Value out of range");
+			encodeFrame(frames, AD567X16_CMD_WRITE_DAC_REG, i, DAC_reg[i]);
+			count++;
 		}
-		return;
+		if ((input_known & mask) && !((DAC_known & mask) && input_reg[i] == DAC_reg[i]))
+		{
+			encodeFrame(frames + count * AD567X16_FRAME_SIZE, AD567X16_CMD_WRITE_INPUT_REG, i, input_reg[i]);
+			count++;
+		}
+		sendFrames(frames, count);
 	}
+	endFrames();
+	_input_known = input_known;
+	_DAC_known = DAC_known;
+	_verify_interval = verify_interval;
 
-	setChannel(channel, static_cast<word>(value / _Vref * 4095), DAC_update, verbose);
-}
+	// Keep a margin below the highest reliable clock
+	_spiClk = best_clk ? best_clk / 100 * (100 - min(margin, (uint8_t)99)) : previous_clk;
 
-void AD567X16Class::setSPIClock(uint32_t clock)
-{
-	_spiClk = clock;
+	if (!best_clk)
+	{
+		return reject(AD567X16_ERROR_STATE, 0);
+	}
+	return AD567X16_OK;
 }
 
-void AD5679RClass::setChannel(uint8_t channel, float value, bool DAC_update, bool verbose)
+bool AD567X16Class::checkPatterns(uint32_t reference_clk)
 {
+	// Alternating and solid patterns, different on every channel, written to the DAC registers (the ones read back)
+	static const word patterns[4] = {0xAAAA, 0x5555, 0xFFFF, 0x0000};
+	uint32_t clk = _spiClk;
+	word resolution_mask = 0xFFFF << _shift;
+	word values[16];
+	word read[16];
+	byte frames[16 * AD567X16_FRAME_SIZE];
+	bool passed = true;
 
-	if (isnan(_Vref))
+	for (uint8_t p = 0; passed && p < 4; p++)
 	{
-		if (verbose)
+		for (uint8_t i = 0; i < 16; i++)
 		{
-			Serial.println("Error: Reference voltage not set");
+			values[i] = (patterns[p] ^ (i * 0x1111)) & resolution_mask;
+			encodeFrame(frames + i * AD567X16_FRAME_SIZE, AD567X16_CMD_WRITE_DAC_REG, i, values[i]);
 		}
-		return;
-	}
 
-	if (value < 0 || value > _Vref)
-	{
-		if (verbose)
+		beginFrames();
+		sendFrames(frames, 16);
+		endFrames();
+
+		// Written at the clock tried and read back at the reference clock, then read back at the clock tried: an
+		// error made the same way in both directions (e.g. on the address bits) cannot cancel out
+		for (uint8_t pass = 0; passed && pass < (clk == reference_clk ? 1 : 2); pass++)
 		{
-			Serial.println("Error: Value out of range");
+			_spiClk = pass ? clk : reference_clk;
+			beginFrames();
+			readRegisters(AD567X16_ALL_CHANNELS, read, 16);
+			endFrames();
+
+			for (uint8_t i = 0; i < 16; i++)
+			{
+				passed = passed && read[i] == values[i];
+			}
 		}
-		return;
+		_spiClk = clk;
 	}
-
-	setChannel(channel, static_cast<word>(value / _Vref * 65535), DAC_update, verbose);
+	return passed;
 }
 
-void AD567X16Class::updateChannels(uint8_t *channels, int num_channels)
+AD567X16Status AD567X16Class::updateChannels(uint8_t *channels, int num_channels)
 {
 
 	word data = 0;
 	for (int i = 0; i < num_channels; i++)
 	{
 		// Check if the channel is within the valid range
-		if (channels[i] < 0 || channels[i] > 15)
+		if (channels[i] > 15)
 		{
-			Serial.println("Error: Channel out of range");
-			return;
+			return reject(AD567X16_ERROR_CHANNEL, 0);
 		}
 		// Set the corresponding bit in the data word
 		data |= (1 << channels[i]);
@@ -211,25 +332,26 @@ void AD567X16Class::updateChannels(uint8_t *channels, int num_channels)
 
 	// Send the data to the DAC
 	writeData(AD567X16_CMD_UPDATE_DAC_REG, 0x00, data);
+	return AD567X16_OK;
 }
 
-void AD567X16Class::powerUpDown(uint8_t channel, bool power_up)
+AD567X16Status AD567X16Class::powerUpDown(uint8_t channel, bool power_up)
 {
-	// Check if the channel is within the valid range
-	if (channel < 0 || channel > 15)
-	{
-		Serial.println("Error: Channel out of range");
-		return;
-	}
-
 	// Call the overloaded function
 	uint8_t channels[1] = {channel};
 	bool power_ups[1] = {power_up};
-	powerUpDown(channels, power_ups, 1);
+	return powerUpDown(channels, power_ups, 1);
 }
 
-void AD567X16Class::powerUpDown(uint8_t *channels, bool *power_up, int num_channels)
+AD567X16Status AD567X16Class::powerUpDown(uint8_t *channels, bool *power_up, int num_channels)
 {
+	// Check all the channels before changing the status registers
+	AD567X16Status status = checkChannels(channels, num_channels);
+	if (status != AD567X16_OK)
+	{
+		return status;
+	}
+
 	// Create flags to check if the status registers have been updated
 	bool update_0 = false;
 	bool update_1 = false;
@@ -237,12 +359,6 @@ void AD567X16Class::powerUpDown(uint8_t *channels, bool *power_up, int num_chann
 	for (int i = 0; i < num_channels; i++)
 	{
 		int channel = channels[i];
-		// Check if the channel is within the valid range
-		if (channel < 0 || channel > 15)
-		{
-			Serial.println("Error: Channel out of range");
-			return;
-		}
 		// Check if the channel is in the first or second batch of 8 channels
 		if (channel > 7)
 		{
@@ -286,28 +402,136 @@ void AD567X16Class::powerUpDown(uint8_t *channels, bool *power_up, int num_chann
 	{
 		writeData(AD567X16_CMD_POWER_UPDOWN, AD567X16_POWER_BATCH_1, _DAC_status_1);
 	}
+	return AD567X16_OK;
 }
 
 void AD567X16Class::resetRegisters(unsigned long delay_ms)
 {
 	// Pulse the RESET pin
-	digitalWrite(_RESET_pin, LOW);
+	_RESET.low();
 	if (delay_ms)
 	{
 		delay(delay_ms);
 	}
-	digitalWrite(_RESET_pin, HIGH);
+	_RESET.high();
+
+	// All the registers are cleared to zero scale
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		_input_reg[i] = 0x0000;
+		_DAC_reg[i] = 0x0000;
+	}
+	_input_known = 0xFFFF;
+	_DAC_known = 0xFFFF;
+	_LDAC_mask = 0x0000;
+	_LDAC_mask_known = true;
+	_LDAC_user_mask = 0x0000;
+	_group_mask = false;
+
+	// All the channels are powered up, with the internal reference
+	_DAC_status_0 = 0x0000;
+	_DAC_status_1 = 0x0000;
+	_reference = AD567X16_REF_INTERNAL_MESSAGE;
+	_setup_known = true;
 }
 
 void AD567X16Class::updateDAC(unsigned long delay_ms)
 {
+	// After a group commit, the channels outside the group are masked: the mask set with setLDACMask is restored first
+	if (_group_mask)
+	{
+		setLDACMask(_LDAC_user_mask);
+	}
+
+	pulseLDAC(delay_ms);
+}
+
+void AD567X16Class::pulseLDAC(unsigned long delay_ms)
+{
+	if (_recorder)
+	{
+		_recorder->LDAC();
+		trackLDAC();
+		return;
+	}
+
 	// Pulse the LDAC pin
-	digitalWrite(_LDAC_pin, LOW);
+	_LDAC.low();
 	if (delay_ms)
 	{
 		delay(delay_ms);
 	}
-	digitalWrite(_LDAC_pin, HIGH);
+	_LDAC.high();
+	trackLDAC();
+}
+
+void AD567X16Class::trackLDAC()
+{
+#if AD567X16_STATS
+	_stats.LDAC_pulses++;
+#endif
+
+	if (!_LDAC_mask_known)
+	{
+		// The updated channels are unknown
+		_DAC_known = 0x0000;
+		return;
+	}
+
+	// The input registers of the channels not masked have been copied to the DAC registers
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		if (!(_LDAC_mask & (1 << i)))
+		{
+			_DAC_reg[i] = _input_reg[i];
+		}
+	}
+	_DAC_known = (_DAC_known & _LDAC_mask) | (_input_known & ~_LDAC_mask);
+}
+
+void AD567X16Class::setLDACMask(word mask)
+{
+	_LDAC_user_mask = mask;
+	writeLDACMask(mask);
+}
+
+void AD567X16Class::writeLDACMask(word mask)
+{
+	// The register is only written when the mask changes
+	_group_mask = false;
+	if (_LDAC_mask_known && mask == _LDAC_mask)
+	{
+		_frames_elided++;
+		return;
+	}
+
+	writeData(AD567X16_CMD_LDAC_MASK_REG, 0x00, mask);
+}
+
+AD567X16Status AD567X16Class::defineGroup(uint8_t group, word channels)
+{
+	if (group >= AD567X16_LDAC_GROUPS)
+	{
+		return reject(AD567X16_ERROR_GROUP, 0);
+	}
+
+	_groups[group] = channels;
+	return AD567X16_OK;
+}
+
+AD567X16Status AD567X16Class::commitGroup(uint8_t group, unsigned long delay_ms)
+{
+	if (group >= AD567X16_LDAC_GROUPS)
+	{
+		return reject(AD567X16_ERROR_GROUP, 0);
+	}
+
+	// Mask every channel outside the group, then a bare LDAC pulse updates the group. The mask stays in place for the
+	// next commits of the group, until updateDAC or setLDACMask.
+	writeLDACMask(~_groups[group]);
+	_group_mask = true;
+	pulseLDAC(delay_ms);
+	return AD567X16_OK;
 }
 
 void AD567X16Class::setReference(bool internal)
@@ -317,12 +541,15 @@ void AD567X16Class::setReference(bool internal)
 	{
 		writeData(AD567X16_CMD_REF_SETUP, 0x00, AD567X16_REF_INTERNAL_MESSAGE);
 		_Vref = 2.5;
+		_Vref_uV = 2500000;
 	}
 	else
 	{
 		writeData(AD567X16_CMD_REF_SETUP, 0x00, AD567X16_REF_EXTERNAL_MESSAGE);
 		_Vref = NAN;
+		_Vref_uV = 0;
 	}
+	updateScale();
 }
 
 void AD567X16Class::setReference(float Vref)
@@ -330,25 +557,944 @@ void AD567X16Class::setReference(float Vref)
 	// Set the reference voltage to external and save the value
 	writeData(AD567X16_CMD_REF_SETUP, 0x00, AD567X16_REF_EXTERNAL_MESSAGE);
 	_Vref = Vref;
+	_Vref_uV = (Vref > 0) ? static_cast<uint32_t>(Vref * 1000000 + 0.5f) : 0;
+	updateScale();
 }
 
-void AD567X16Class::writeData(byte command, byte address, word data)
+AD567X16Status AD567X16Class::setChannelMillivolts(uint8_t channel, uint16_t millivolts, bool DAC_update, bool verbose)
+{
+	return setChannelMicrovolts(channel, (uint32_t)millivolts * 1000, DAC_update, verbose);
+}
+
+// Upper 32 bits of a 32 x 32-bit product, from 16 x 16-bit partial products (cheap on 8-bit cores)
+static inline uint32_t AD567X16_mulhi32(uint32_t a, uint32_t b)
+{
+	uint16_t a_lo = a & 0xFFFF, a_hi = a >> 16;
+	uint16_t b_lo = b & 0xFFFF, b_hi = b >> 16;
+
+	uint32_t low = (uint32_t)a_lo * b_lo;
+	uint32_t mid_1 = (uint32_t)a_hi * b_lo + (low >> 16);
+	uint32_t mid_2 = (uint32_t)a_lo * b_hi + (mid_1 & 0xFFFF);
+	return (uint32_t)a_hi * b_hi + (mid_1 >> 16) + (mid_2 >> 16);
+}
+
+AD567X16Status AD567X16Class::setChannelMicrovolts(uint8_t channel, uint32_t microvolts, bool DAC_update, bool verbose)
+{
+	if (channel > 15)
+	{
+		return reject(AD567X16_ERROR_CHANNEL, verbose);
+	}
+
+	if (!_Vref_uV)
+	{
+		return reject(AD567X16_ERROR_REFERENCE, verbose);
+	}
+
+	if (microvolts > _Vref_uV)
+	{
+		return reject(AD567X16_ERROR_VALUE, verbose);
+	}
+
+#if AD567X16_CALIBRATION
+	// Scale and gain correction in a single fixed-point multiplication, then offset correction
+	int32_t code = (int32_t)AD567X16_mulhi32(microvolts, _uV_scale[channel]) + _cal_offset[channel];
+	code = constrain(code, (int32_t)0, (int32_t)(0xFFFF >> _shift));
+#else
+	// Single fixed-point multiplication, at most the full scale code as microvolts <= reference
+	uint32_t code = AD567X16_mulhi32(microvolts, _uV_scale);
+#endif
+
+	return pushChannel(channel, (word)code << _shift, DAC_update, verbose);
+}
+
+#if AD567X16_CALIBRATION
+AD567X16Status AD567X16Class::setCalibration(uint8_t channel, int32_t gain_ppm, int16_t offset)
+{
+	if (channel > 15)
+	{
+		return reject(AD567X16_ERROR_CHANNEL, 0);
+	}
+
+	// Corrected code = code * (1 + gain_ppm / 1e6) + offset, in the model resolution
+	_cal_gain[channel] = gain_ppm;
+	_cal_offset[channel] = offset;
+	updateScale();
+	return AD567X16_OK;
+}
+
+void AD567X16Class::clearCalibration()
+{
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		_cal_gain[i] = 0;
+		_cal_offset[i] = 0;
+	}
+	updateScale();
+}
+#endif
+
+void AD567X16Class::updateScale()
+{
+	// Full scale code / reference, in Q32, computed here once rather than on every write. Rounded up, so that the
+	// reference itself gives the full scale code (the error stays below 1 LSB for any voltage up to the reference)
+	uint32_t scale = _Vref_uV ? (uint32_t)((((uint64_t)(0xFFFF >> _shift) << 32) + _Vref_uV - 1) / _Vref_uV) : 0;
+
+#if AD567X16_CALIBRATION
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		uint64_t corrected = (uint64_t)scale * (uint32_t)(1000000L + _cal_gain[i]) / 1000000UL;
+		_uV_scale[i] = corrected > 0xFFFFFFFFUL ? 0xFFFFFFFFUL : (uint32_t)corrected;
+	}
+#else
+	_uV_scale = scale;
+#endif
+}
+
+AD567X16Status AD567X16Class::setChannels(const uint8_t *channels, const word *values, int num_channels, bool DAC_update, bool LDAC_commit)
+{
+	AD567X16Status status = checkChannels(channels, num_channels);
+	if (status != AD567X16_OK)
+	{
+		return status;
+	}
+
+	byte command = DAC_update ? AD567X16_CMD_WRITE_DAC_REG : AD567X16_CMD_WRITE_INPUT_REG;
+
+	// Send every frame within a single SPI transaction
+	beginFrames();
+	writeChannels(channels, values, num_channels, command);
+	endFrames();
+
+	// Commit the input registers with a single LDAC pulse
+	if (LDAC_commit && !DAC_update)
+	{
+		updateDAC();
+	}
+	return AD567X16_OK;
+}
+
+AD567X16Status AD567X16Class::setChannels(const uint8_t *channels, const float *values, int num_channels, bool DAC_update, bool LDAC_commit)
+{
+	AD567X16Status status = checkChannels(channels, num_channels);
+
+	// Check the whole batch before sending anything
+	for (int i = 0; i < num_channels && status == AD567X16_OK; i++)
+	{
+		status = checkVoltage(values[i]);
+	}
+	if (status != AD567X16_OK)
+	{
+		return status;
+	}
+
+	byte command = DAC_update ? AD567X16_CMD_WRITE_DAC_REG : AD567X16_CMD_WRITE_INPUT_REG;
+	word codes[AD567X16_BURST_FRAMES];
+
+	beginFrames();
+	for (int i = 0; i < num_channels; i += AD567X16_BURST_FRAMES)
+	{
+		int count = min(num_channels - i, AD567X16_BURST_FRAMES);
+		for (int j = 0; j < count; j++)
+		{
+			codes[j] = voltageToCode(values[i + j]);
+		}
+		writeChannels(channels + i, codes, count, command);
+	}
+	endFrames();
+
+	if (LDAC_commit && !DAC_update)
+	{
+		updateDAC();
+	}
+	return AD567X16_OK;
+}
+
+AD567X16Status AD567X16Class::setChannels(const word *values, bool DAC_update, bool LDAC_commit)
+{
+	return setChannels(AD567X16_ALL_CHANNELS, values, 16, DAC_update, LDAC_commit);
+}
+
+AD567X16Status AD567X16Class::setChannels(const float *values, bool DAC_update, bool LDAC_commit)
+{
+	return setChannels(AD567X16_ALL_CHANNELS, values, 16, DAC_update, LDAC_commit);
+}
+
+AD567X16Status AD567X16Class::checkChannels(const uint8_t *channels, int num_channels, bool verbose)
+{
+	for (int i = 0; i < num_channels; i++)
+	{
+		// Check if the channel is within the valid range
+		if (channels[i] > 15)
+		{
+			return reject(AD567X16_ERROR_CHANNEL, verbose);
+		}
+	}
+	return AD567X16_OK;
+}
+
+AD567X16Status AD567X16Class::checkVoltage(float value, bool verbose)
+{
+	if (isnan(_Vref))
+	{
+		return reject(AD567X16_ERROR_REFERENCE, verbose);
+	}
+
+	if (value < 0 || value > _Vref)
+	{
+		return reject(AD567X16_ERROR_VALUE, verbose);
+	}
+	return AD567X16_OK;
+}
+
+AD567X16Status AD567X16Class::reject(AD567X16Status status, bool verbose)
+{
+	countRejected();
+#if AD567X16_LOG_LEVEL >= AD567X16_LOG_ERROR
+	logMessage(F("Error: "), AD567X16StatusMessage(status), verbose);
+#else
+	(void)verbose;
+#endif
+	return status;
+}
+
+#if AD567X16_LOG_LEVEL > AD567X16_LOG_NONE
+void AD567X16Class::logMessage(const __FlashStringHelper *level, const __FlashStringHelper *message, bool verbose)
+{
+	// Messages go to the log output if one is set, else to Serial for the calls made with verbose set
+	Print *output = _log_output ? _log_output : (verbose ? &Serial : nullptr);
+	if (output)
+	{
+		output->print(level);
+		output->println(message);
+	}
+}
+#endif
+
+const __FlashStringHelper *AD567X16StatusMessage(AD567X16Status status)
+{
+	switch (status)
+	{
+	case AD567X16_OK:
+		return F("OK");
+	case AD567X16_ERROR_CHANNEL:
+		return F("Channel out of range");
+	case AD567X16_ERROR_VALUE:
+		return F("Value out of range");
+	case AD567X16_ERROR_REFERENCE:
+		return F("Reference voltage not set");
+	case AD567X16_ERROR_GROUP:
+		return F("Group out of range");
+	case AD567X16_ERROR_DEVICE:
+		return F("Device out of range");
+	case AD567X16_ERROR_STATE:
+		return F("Register state unknown or unavailable, or invalid snapshot");
+	case AD567X16_ERROR_FULL:
+		return F("No room left");
+	}
+	return F("Unknown status");
+}
+
+word AD567X16Class::voltageToCode(float value)
+{
+	// Full scale of the model resolution (4095 or 65535)
+	return static_cast<word>(value / _Vref * (0xFFFF >> _shift));
+}
+
+void AD567X16Class::writeChannels(const uint8_t *channels, const word *values, int num_channels, byte command)
+{
+	// When all the channels are written and most share a value, a broadcast frame is cheaper
+	if (num_channels >= 16 && writeBroadcast(channels, values, num_channels, command))
+	{
+		return;
+	}
+
+	byte frames[AD567X16_BURST_FRAMES * AD567X16_FRAME_SIZE];
+
+	int count = 0;
+
+	// Pack the frames into one buffer, AD567X16_BURST_FRAMES at a time, skipping unchanged values
+	for (int i = 0; i < num_channels; i++)
+	{
+		word value = values[i] << _shift;
+		if (unchanged(channels[i], value, command))
+		{
+			_frames_elided++;
+			continue;
+		}
+
+		// Track the frame right away, so that repeated channels are compared with the latest value
+		encodeFrame(frames + count * AD567X16_FRAME_SIZE, command, channels[i], value);
+		trackFrame(frames + count * AD567X16_FRAME_SIZE);
+		if (++count == AD567X16_BURST_FRAMES)
+		{
+			transferFrames(frames, count);
+			count = 0;
+		}
+	}
+	transferFrames(frames, count);
+}
+
+AD567X16Status AD567X16Class::stageChannel(uint8_t channel, word value)
+{
+	if (channel > 15)
+	{
+		return reject(AD567X16_ERROR_CHANNEL, 0);
+	}
+
+	// Keep the value until the next flush()
+	_staged[channel] = value << _shift;
+	_dirty |= (1 << channel);
+	return AD567X16_OK;
+}
+
+AD567X16Status AD567X16Class::stageChannel(uint8_t channel, float value)
+{
+	AD567X16Status status = checkVoltage(value);
+	if (status != AD567X16_OK)
+	{
+		return status;
+	}
+
+	return stageChannel(channel, voltageToCode(value));
+}
+
+void AD567X16Class::flush(bool DAC_update)
+{
+	if (!_dirty)
+	{
+		return;
+	}
+
+	byte frames[AD567X16_STAGED_FRAMES * AD567X16_FRAME_SIZE];
+	int num_frames = encodeStaged(frames, DAC_update);
+
+	if (num_frames)
+	{
+		beginFrames();
+		sendFrames(frames, num_frames);
+		endFrames();
+	}
+}
+
+int AD567X16Class::encodeStaged(byte *frames, bool DAC_update)
+{
+	// One frame per channel, plus one update frame for the whole batch
+	int num_frames = 0;
+	word update_mask = 0x0000;
+
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		if (!(_dirty & (1 << i)))
+		{
+			continue;
+		}
+
+		word value = _staged[i];
+		byte command = DAC_update ? AD567X16_CMD_WRITE_DAC_REG : AD567X16_CMD_WRITE_INPUT_REG;
+		if (unchanged(i, value, command))
+		{
+			_frames_elided++;
+		}
+		else if (DAC_update && unchanged(i, value, AD567X16_CMD_WRITE_INPUT_REG))
+		{
+			// The input register already holds the value, only the DAC register needs updating
+			update_mask |= (1 << i);
+		}
+		else
+		{
+			encodeFrame(frames + num_frames * AD567X16_FRAME_SIZE, command, i, value);
+			num_frames++;
+		}
+	}
+	_dirty = 0x0000;
+
+	if (update_mask)
+	{
+		encodeFrame(frames + num_frames * AD567X16_FRAME_SIZE, AD567X16_CMD_UPDATE_DAC_REG, 0x00, update_mask);
+		num_frames++;
+	}
+	return num_frames;
+}
+
+void AD567X16Class::invalidateShadow()
+{
+	// Force the next writes to be sent, e.g. after the DAC has been reset externally
+	_input_known = 0x0000;
+	_DAC_known = 0x0000;
+	_LDAC_mask_known = false;
+	_setup_known = false;
+}
+
+void AD567X16Class::record(AD567X16ProgramClass *program)
+{
+	// The frames go to the program instead of the device, so its registers are unknown when recording starts or
+	// stops. Within a recording, the writes are still elided against the earlier recorded ones.
+	_recorder = program;
+	invalidateShadow();
+}
+
+AD567X16Status AD567X16Class::readChannel(uint8_t channel, word &value)
+{
+	return readChannels(&channel, &value, 1);
+}
+
+AD567X16Status AD567X16Class::readChannels(const uint8_t *channels, word *values, int num_channels)
+{
+	AD567X16Status status = checkChannels(channels, num_channels);
+	if (status != AD567X16_OK)
+	{
+		return status;
+	}
+	// A program cannot return what the device holds
+	if (_recorder)
+	{
+		return reject(AD567X16_ERROR_STATE, 0);
+	}
+
+	beginFrames();
+	readRegisters(channels, values, num_channels);
+	endFrames();
+
+	for (int i = 0; i < num_channels; i++)
+	{
+		values[i] >>= _shift;
+	}
+	return AD567X16_OK;
+}
+
+AD567X16Status AD567X16Class::readChannels(word *values)
+{
+	return readChannels(AD567X16_ALL_CHANNELS, values, 16);
+}
+
+AD567X16Status AD567X16Class::resync(word *repaired)
+{
+	if (_recorder)
+	{
+		return reject(AD567X16_ERROR_STATE, 0);
+	}
+
+	// Desired outputs: the DAC registers known to the library
+	word desired[16];
+	word known = _DAC_known;
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		desired[i] = _DAC_reg[i];
+	}
+
+	beginFrames();
+
+	// The readback replaces the shadow with the contents of the device
+	word hardware[16];
+	readRegisters(AD567X16_ALL_CHANNELS, hardware, 16);
+
+	// Rewrite only the channels that differ, in the same transaction
+	uint8_t channels[16];
+	word values[16];
+	int count = 0;
+	word mismatch = 0x0000;
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		if ((known & (1 << i)) && hardware[i] != desired[i])
+		{
+			channels[count] = i;
+			values[count] = desired[i] >> _shift;
+			count++;
+			mismatch |= (1 << i);
+		}
+	}
+	writeChannels(channels, values, count, AD567X16_CMD_WRITE_DAC_REG);
+
+	endFrames();
+
+	if (repaired)
+	{
+		*repaired = mismatch;
+	}
+	return AD567X16_OK;
+}
+
+void AD567X16Class::setVerify(uint8_t interval)
+{
+	_verify_interval = interval;
+	_verify_countdown = interval;
+}
+
+void AD567X16Class::readRegisters(const uint8_t *channels, word *values, int num_channels)
+{
+	// Pipelined readback: each frame clocks out on SDO the register selected by the previous one, and a final NOP
+	// frame clocks out the last one
+	byte frame[AD567X16_FRAME_SIZE];
+	for (int i = 0; i <= num_channels; i++)
+	{
+		if (i < num_channels)
+		{
+			encodeFrame(frame, AD567X16_CMD_READBACK, channels[i], 0x0000);
+		}
+		else
+		{
+			encodeFrame(frame, AD567X16_CMD_NOP, 0x00, 0x0000);
+		}
+		trackFrame(frame);
+
+		_transport->transferFrames(frame, 1, _CS);
+
+		if (i)
+		{
+			// The DAC register read is now known
+			uint8_t channel = channels[i - 1];
+			values[i - 1] = (frame[1] << 8) | frame[2];
+			_DAC_reg[channel] = values[i - 1];
+			_DAC_known |= (1 << channel);
+		}
+	}
+}
+
+int AD567X16Class::sampleVerify(const byte *frames, int num_frames)
+{
+	// One DAC register write in _verify_interval is sampled, at most one per call
+	int sampled = -1;
+	for (int i = 0; i < num_frames; i++)
+	{
+		if ((frames[i * AD567X16_FRAME_SIZE] >> 4) == AD567X16_CMD_WRITE_DAC_REG && !--_verify_countdown)
+		{
+			sampled = frames[i * AD567X16_FRAME_SIZE] & 0x0F;
+			_verify_countdown = _verify_interval;
+		}
+	}
+	return sampled;
+}
+
+void AD567X16Class::verifyChannel(uint8_t channel)
+{
+	word expected = _DAC_reg[channel];
+	bool known = _DAC_known & (1 << channel);
+	word value;
+	readRegisters(&channel, &value, 1);
+	if (known && value != expected)
+	{
+		// Keep the value read, and write the channel again on the next call
+		_verify_errors++;
+		_input_known &= ~(1 << channel);
+#if AD567X16_LOG_LEVEL >= AD567X16_LOG_ERROR
+		logMessage(F("Error: "), F("Readback mismatch"), 0);
+#endif
+	}
+}
+
+// Fletcher-16 checksum of a snapshot, up to its checksum field
+static uint16_t AD567X16_snapshotChecksum(const AD567X16Snapshot &snapshot)
+{
+	const byte *data = reinterpret_cast<const byte *>(&snapshot);
+	uint16_t sum_1 = 0;
+	uint16_t sum_2 = 0;
+	for (size_t i = 0; i < offsetof(AD567X16Snapshot, checksum); i++)
+	{
+		sum_1 = (sum_1 + data[i]) % 255;
+		sum_2 = (sum_2 + sum_1) % 255;
+	}
+	return (sum_2 << 8) | sum_1;
+}
+
+AD567X16Status AD567X16Class::snapshot(AD567X16Snapshot &snapshot)
+{
+	// The outputs must be known to be saved
+	if (_DAC_known != 0xFFFF)
+	{
+		return reject(AD567X16_ERROR_STATE, 0);
+	}
+
+	memset(&snapshot, 0, sizeof(snapshot));
+	snapshot.magic = AD567X16_SNAPSHOT_MAGIC;
+	snapshot.resolution = resolution();
+	snapshot.reference = _reference;
+	snapshot.Vref_uV = _Vref_uV;
+	snapshot.SPI_clock = _spiClk;
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		snapshot.DAC_reg[i] = _DAC_reg[i];
+	}
+	snapshot.power[0] = _DAC_status_0;
+	snapshot.power[1] = _DAC_status_1;
+	snapshot.LDAC_mask = _group_mask ? _LDAC_user_mask : (_LDAC_mask_known ? _LDAC_mask : 0x0000);
+	snapshot.checksum = AD567X16_snapshotChecksum(snapshot);
+	return AD567X16_OK;
+}
+
+AD567X16Status AD567X16Class::restore(const AD567X16Snapshot &snapshot)
 {
+	if (snapshot.magic != AD567X16_SNAPSHOT_MAGIC || snapshot.resolution != resolution() ||
+		snapshot.checksum != AD567X16_snapshotChecksum(snapshot))
+	{
+		return reject(AD567X16_ERROR_STATE, 0);
+	}
+
+	if (snapshot.SPI_clock)
+	{
+		_spiClk = snapshot.SPI_clock;
+	}
+
+	// Only the registers differing from the shadow are written, all in one transaction
+	byte frames[4 * AD567X16_FRAME_SIZE];
+	int count = 0;
 
-	// Start SPI by selecting the slave
-	_spi->beginTransaction(SPISettings(_spiClk, MSBFIRST, SPI_MODE1));
+	beginFrames();
 
-	digitalWrite(_CS_pin, LOW);
+	// Reference first, so that the outputs are right as soon as they are updated
+	if (!_setup_known || snapshot.reference != _reference)
+	{
+		encodeFrame(frames, AD567X16_CMD_REF_SETUP, 0x00, snapshot.reference);
+		sendFrames(frames, 1);
+	}
 
-	// Combine command and address into one byte and send
-	_spi->transfer((command << 4) | (address & 0x0F));
+	// Input registers: a broadcast of the most common value and one frame per exception, when cheaper
+	word values[16];
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		values[i] = snapshot.DAC_reg[i] >> _shift;
+	}
+	writeChannels(AD567X16_ALL_CHANNELS, values, 16, AD567X16_CMD_WRITE_INPUT_REG);
 
-	// Send the data (16 bits) in two transfers
-	_spi->transfer16(data);
+	// One power frame per batch of 8 channels
+	if (!_setup_known || snapshot.power[0] != _DAC_status_0)
+	{
+		encodeFrame(frames + count++ * AD567X16_FRAME_SIZE, AD567X16_CMD_POWER_UPDOWN, AD567X16_POWER_BATCH_0, snapshot.power[0]);
+	}
+	if (!_setup_known || snapshot.power[1] != _DAC_status_1)
+	{
+		encodeFrame(frames + count++ * AD567X16_FRAME_SIZE, AD567X16_CMD_POWER_UPDOWN, AD567X16_POWER_BATCH_1, snapshot.power[1]);
+	}
 
-	// End SPI by deselecting the slave
-	digitalWrite(_CS_pin, HIGH);
+	if (!_LDAC_mask_known || snapshot.LDAC_mask != _LDAC_mask)
+	{
+		encodeFrame(frames + count++ * AD567X16_FRAME_SIZE, AD567X16_CMD_LDAC_MASK_REG, 0x00, snapshot.LDAC_mask);
+	}
+
+	// A single update frame commits every output that differs. Unlike the LDAC pin, it ignores the LDAC mask.
+	word update = 0x0000;
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		if (!(_DAC_known & (1 << i)) || _DAC_reg[i] != snapshot.DAC_reg[i])
+		{
+			update |= (1 << i);
+		}
+	}
+	if (update)
+	{
+		encodeFrame(frames + count++ * AD567X16_FRAME_SIZE, AD567X16_CMD_UPDATE_DAC_REG, 0x00, update);
+	}
+
+	sendFrames(frames, count);
+	endFrames();
+
+	_setup_known = true;
+	_LDAC_user_mask = snapshot.LDAC_mask;
+	_group_mask = false;
+	_Vref_uV = snapshot.Vref_uV;
+	_Vref = _Vref_uV ? _Vref_uV / 1000000.0f : NAN;
+	updateScale();
+	return AD567X16_OK;
+}
+
+#if AD567X16_EEPROM
+AD567X16Status AD567X16Class::saveSnapshot(int address)
+{
+	AD567X16Snapshot state;
+	AD567X16Status status = snapshot(state);
+	if (status != AD567X16_OK)
+	{
+		return status;
+	}
+
+	EEPROM.put(address, state);
+#if defined(ARDUINO_ARCH_ESP32) || defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_RP2040)
+	// EEPROM emulated in flash (NVS on the ESP32): EEPROM.begin() must have been called
+	EEPROM.commit();
+#endif
+	return AD567X16_OK;
+}
+
+AD567X16Status AD567X16Class::restoreSnapshot(int address)
+{
+	AD567X16Snapshot state;
+	EEPROM.get(address, state);
+	return restore(state);
+}
+#endif
+
+void AD567X16Class::clearFrameCounters()
+{
+	_frames_sent = 0;
+	_frames_elided = 0;
+}
+
+#if AD567X16_STATS
+void AD567X16Class::resetStats()
+{
+	memset(&_stats, 0, sizeof(_stats));
+}
+#endif
+
+bool AD567X16Class::unchanged(uint8_t channel, word value, byte command)
+{
+	word mask = 1 << channel;
+	bool input = (_input_known & mask) && _input_reg[channel] == value;
+
+	if (command == AD567X16_CMD_WRITE_INPUT_REG)
+	{
+		return input;
+	}
+	return input && (_DAC_known & mask) && _DAC_reg[channel] == value;
+}
+
+void AD567X16Class::trackFrame(const byte *frame)
+{
+	byte command = frame[0] >> 4;
+	uint8_t address = frame[0] & 0x0F;
+	word data = (frame[1] << 8) | frame[2];
+	word mask = 1 << address;
+
+	// Mirror the effect of the frame on the device registers
+	switch (command)
+	{
+	case AD567X16_CMD_WRITE_INPUT_REG:
+		_input_reg[address] = data;
+		_input_known |= mask;
+		break;
+	case AD567X16_CMD_WRITE_DAC_REG:
+		_input_reg[address] = data;
+		_DAC_reg[address] = data;
+		_input_known |= mask;
+		_DAC_known |= mask;
+		break;
+	case AD567X16_CMD_UPDATE_DAC_REG:
+		for (uint8_t i = 0; i < 16; i++)
+		{
+			if (data & (1 << i))
+			{
+				_DAC_reg[i] = _input_reg[i];
+			}
+		}
+		_DAC_known = (_DAC_known & ~data) | (_input_known & data);
+		break;
+	case AD567X16_CMD_LDAC_MASK_REG:
+		_LDAC_mask = data;
+		_LDAC_mask_known = true;
+		_group_mask = false;
+		break;
+	case AD567X16_CMD_POWER_UPDOWN:
+		if (address & AD567X16_POWER_BATCH_1)
+		{
+			_DAC_status_1 = data;
+		}
+		else
+		{
+			_DAC_status_0 = data;
+		}
+		break;
+	case AD567X16_CMD_REF_SETUP:
+		_reference = data & AD567X16_REF_EXTERNAL_MESSAGE;
+		break;
+	case AD567X16_CMD_WRITE_ALL_INPUT:
+		for (uint8_t i = 0; i < 16; i++)
+		{
+			_input_reg[i] = data;
+		}
+		_input_known = 0xFFFF;
+		break;
+	case AD567X16_CMD_WRITE_ALL_DAC:
+		for (uint8_t i = 0; i < 16; i++)
+		{
+			_input_reg[i] = data;
+			_DAC_reg[i] = data;
+		}
+		_input_known = 0xFFFF;
+		_DAC_known = 0xFFFF;
+		break;
+	case AD567X16_CMD_RESET:
+		invalidateShadow();
+		break;
+	}
+
+	_frames_sent++;
+#if AD567X16_STATS
+	_stats.frames[command]++;
+	_stats.bytes += AD567X16_FRAME_SIZE;
+#endif
+}
+
+bool AD567X16Class::writeBroadcast(const uint8_t *channels, const word *values, int num_channels, byte command)
+{
+	// Final value of every channel (the last one wins for repeated channels)
+	word final_values[16];
+	word covered = 0x0000;
+	for (int i = 0; i < num_channels; i++)
+	{
+		final_values[channels[i]] = values[i] << _shift;
+		covered |= (1 << channels[i]);
+	}
+	if (covered != 0xFFFF)
+	{
+		return false;
+	}
+
+	// Most common value, and the number of frames needed without broadcast
+	word common = final_values[0];
+	uint8_t common_count = 0;
+	uint8_t changed = 0;
+	word update = 0x0000; // Channels whose output changes
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		uint8_t count = 0;
+		for (uint8_t j = 0; j < 16; j++)
+		{
+			count += (final_values[j] == final_values[i]);
+		}
+		if (count > common_count)
+		{
+			common = final_values[i];
+			common_count = count;
+		}
+		if (!unchanged(i, final_values[i], command))
+		{
+			changed++;
+			update |= (1 << i);
+		}
+	}
+
+	// The broadcast always goes to the input registers: broadcasting to the DAC registers would briefly drive the
+	// exceptions to the common value. The DAC registers are then updated by a single update frame.
+	bool DAC_update = (command == AD567X16_CMD_WRITE_DAC_REG);
+
+	// Broadcast frame, then one frame per exception, and the update frame
+	if (1 + (16 - common_count) + DAC_update >= changed)
+	{
+		return false;
+	}
+
+	byte frames[16 * AD567X16_FRAME_SIZE];
+	int count = 0;
+
+	encodeFrame(frames, AD567X16_CMD_WRITE_ALL_INPUT, 0x00, common);
+	count++;
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		if (final_values[i] != common)
+		{
+			encodeFrame(frames + count * AD567X16_FRAME_SIZE, AD567X16_CMD_WRITE_INPUT_REG, i, final_values[i]);
+			count++;
+		}
+	}
+	if (DAC_update)
+	{
+		encodeFrame(frames + count * AD567X16_FRAME_SIZE, AD567X16_CMD_UPDATE_DAC_REG, 0x00, update);
+		count++;
+	}
+
+	_frames_elided += num_channels - count;
+	sendFrames(frames, count);
+	return true;
+}
+
+AD567X16Status AD567X16Class::setAll(word value, bool DAC_update)
+{
+	word data = value << _shift;
+	byte command = DAC_update ? AD567X16_CMD_WRITE_ALL_DAC : AD567X16_CMD_WRITE_ALL_INPUT;
+
+	// Skip the frame if every register already holds the value
+	bool same = true;
+	for (uint8_t i = 0; i < 16 && same; i++)
+	{
+		same = unchanged(i, data, DAC_update ? AD567X16_CMD_WRITE_DAC_REG : AD567X16_CMD_WRITE_INPUT_REG);
+	}
+	if (same)
+	{
+		_frames_elided++;
+		return AD567X16_OK;
+	}
+
+	// A single frame writes all the channels
+	writeData(command, 0x00, data);
+	return AD567X16_OK;
+}
+
+AD567X16Status AD567X16Class::setAll(float value, bool DAC_update, bool verbose)
+{
+	AD567X16Status status = checkVoltage(value, verbose);
+	if (status != AD567X16_OK)
+	{
+		return status;
+	}
+
+	return setAll(voltageToCode(value), DAC_update);
+}
+
+void AD567X16Class::encodeFrame(byte *frame, byte command, byte address, word data)
+{
+	// Command and address in the first byte, followed by the data (MSB first)
+	frame[0] = (command << 4) | (address & 0x0F);
+	frame[1] = highByte(data);
+	frame[2] = lowByte(data);
+}
+
+void AD567X16Class::beginFrames()
+{
+#if AD567X16_STATS
+	_stats_start = AD567X16_STATS_CLOCK();
+#endif
+	_transport->begin(_spiClk);
+}
+
+void AD567X16Class::sendFrames(byte *frames, int num_frames)
+{
+	for (int i = 0; i < num_frames; i++)
+	{
+		trackFrame(frames + i * AD567X16_FRAME_SIZE);
+	}
+	transferFrames(frames, num_frames);
+}
+
+void AD567X16Class::transferFrames(byte *frames, int num_frames)
+{
+	if (_recorder)
+	{
+		_recorder->append(frames, num_frames);
+		return;
+	}
+
+	// The transport overwrites the buffer with the data received, so the write to verify is sampled first
+	int verified = _verify_interval ? sampleVerify(frames, num_frames) : -1;
+
+	_transport->transferFrames(frames, num_frames, _CS);
+
+	if (verified >= 0)
+	{
+		verifyChannel(verified);
+	}
+}
+
+void AD567X16Class::endFrames()
+{
+	_transport->end();
+#if AD567X16_STATS
+	// Bin of the transaction duration: number of significant bits, saturated to the last bin
+	uint32_t duration = AD567X16_STATS_CLOCK() - _stats_start;
+	uint8_t bin = 0;
+	while (duration && bin < AD567X16_STATS_BINS - 1)
+	{
+		duration >>= 1;
+		bin++;
+	}
+	_stats.latency[bin]++;
+#endif
+}
+
+void AD567X16Class::writeData(byte command, byte address, word data)
+{
+	byte frame[AD567X16_FRAME_SIZE];
+	encodeFrame(frame, command, address, data);
 
-	// End SPI transaction
-	_spi->endTransaction();
+	beginFrames();
+	sendFrames(frame, 1);
+	endFrames();
 }
\ No newline at end of file
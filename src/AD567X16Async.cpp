@@ -0,0 +1,296 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+AD567X16Async.cpp - Non-blocking transfers for the Analog Devices AD567X 16-channel DACs.
+*/
+
+#include <AD567X16Async.h>
+
+#define AD567X16_ASYNC_MASK (AD567X16_ASYNC_QUEUE_SIZE - 1)
+
+AD567X16AsyncClass::AD567X16AsyncClass(AD567X16Class &dac, AD567X16AsyncBackend &backend)
+{
+	_dac = &dac;
+	_backend = &backend;
+}
+
+void AD567X16AsyncClass::begin()
+{
+	_backend->begin(this, _dac->_spiClk);
+}
+
+void AD567X16AsyncClass::onComplete(AD567X16Callback callback, void *context)
+{
+	_callback = callback;
+	_context = context;
+}
+
+uint8_t AD567X16AsyncClass::available() const
+{
+	// One slot is kept free to tell a full queue from an empty one
+	return AD567X16_ASYNC_MASK - ((_head - _tail) & AD567X16_ASYNC_MASK);
+}
+
+bool AD567X16AsyncClass::write(byte command, byte address, word data)
+{
+	if (!available())
+	{
+		return false;
+	}
+
+	enqueue(command, address, data);
+	start();
+	return true;
+}
+
+bool AD567X16AsyncClass::setChannel(uint8_t channel, word value, bool DAC_update)
+{
+	return setChannels(&channel, &value, 1, DAC_update);
+}
+
+bool AD567X16AsyncClass::setChannels(const uint8_t *channels, const word *values, int num_channels, bool DAC_update)
+{
+	if (_dac->checkChannels(channels, num_channels) != AD567X16_OK || num_channels > available())
+	{
+		return false;
+	}
+
+	byte command = DAC_update ? AD567X16_CMD_WRITE_DAC_REG : AD567X16_CMD_WRITE_INPUT_REG;
+	for (int i = 0; i < num_channels; i++)
+	{
+		// Unchanged values are not queued
+		word value = values[i] << _dac->_shift;
+		if (_dac->unchanged(channels[i], value, command))
+		{
+			_dac->_frames_elided++;
+			continue;
+		}
+		enqueue(command, channels[i], value);
+	}
+	start();
+	return true;
+}
+
+bool AD567X16AsyncClass::commit(bool LDAC_pulse)
+{
+	if (LDAC_pulse && _dac->_group_mask)
+	{
+		// After a group commit, the mask set with setLDACMask is restored before the pulse, as by updateDAC
+		if (_dac->_LDAC_mask_known && _dac->_LDAC_mask == _dac->_LDAC_user_mask)
+		{
+			_dac->_frames_elided++;
+		}
+		else if (available())
+		{
+			enqueue(AD567X16_CMD_LDAC_MASK_REG, 0x00, _dac->_LDAC_user_mask);
+			start();
+		}
+		else
+		{
+			return false;
+		}
+		_dac->_group_mask = false;
+	}
+
+	noInterrupts();
+	if (_head == _tail)
+	{
+		interrupts();
+		// Nothing left in the queue, complete the batch right away
+		if (LDAC_pulse)
+		{
+			_dac->updateDAC();
+		}
+		if (_callback)
+		{
+			_callback(_context);
+		}
+		return true;
+	}
+
+	// Flag the last queued frame as the end of the batch
+	uint8_t last = (_head - 1) & AD567X16_ASYNC_MASK;
+	_flags[last] |= AD567X16_ASYNC_END_BATCH | (LDAC_pulse ? AD567X16_ASYNC_LDAC : 0);
+	if (LDAC_pulse)
+	{
+		// Like the frames, the pulse is tracked when queued: it latches the input registers as they are at this point
+		// of the queue, not the ones written by the frames queued after it
+		_dac->trackLDAC();
+	}
+	interrupts();
+	return true;
+}
+
+void AD567X16AsyncClass::enqueue(byte command, byte address, word data)
+{
+	uint8_t head = _head;
+	AD567X16Class::encodeFrame(_frames[head], command, address, data);
+	_flags[head] = 0;
+
+	// The shadow registers describe the state once the queue has been sent
+	_dac->trackFrame(_frames[head]);
+
+	// Publish the frame to the transmitter
+	_head = (head + 1) & AD567X16_ASYNC_MASK;
+}
+
+void AD567X16AsyncClass::start()
+{
+	noInterrupts();
+	if (!_active && _head != _tail)
+	{
+		_active = true;
+		_backend->beginFrames();
+		_dac->_CS.low();
+		_backend->startFrame(_frames[_tail]);
+	}
+	interrupts();
+}
+
+void AD567X16AsyncClass::frameDone()
+{
+	// The DAC executes the frame on the rising edge of CS
+	_dac->_CS.high();
+
+	uint8_t tail = _tail;
+	byte flags = _flags[tail];
+	_tail = (tail + 1) & AD567X16_ASYNC_MASK;
+
+	if (flags & AD567X16_ASYNC_LDAC)
+	{
+		// Pulsed directly, without any SPI traffic from the interrupt: commit() has queued the mask and tracked the
+		// pulse
+		_dac->_LDAC.low();
+		_dac->_LDAC.high();
+	}
+
+	if (_tail != _head)
+	{
+		_dac->_CS.low();
+		_backend->startFrame(_frames[_tail]);
+	}
+	else
+	{
+		_active = false;
+		_backend->endFrames();
+	}
+
+	if ((flags & AD567X16_ASYNC_END_BATCH) && _callback)
+	{
+		_callback(_context);
+	}
+}
+
+void AD567X16PolledBackend::begin(AD567X16AsyncClass *engine, uint32_t clk)
+{
+	_engine = engine;
+	_settings = SPISettings(clk, MSBFIRST, SPI_MODE1);
+}
+
+void AD567X16PolledBackend::startFrame(const byte *frame)
+{
+	// Sent on the next poll() call
+	_frame = frame;
+}
+
+bool AD567X16PolledBackend::poll()
+{
+	const byte *frame = _frame;
+	if (!frame)
+	{
+		return false;
+	}
+
+	byte buffer[AD567X16_FRAME_SIZE] = {frame[0], frame[1], frame[2]};
+	_frame = nullptr;
+
+	_spi->beginTransaction(_settings);
+	_spi->transfer(buffer, AD567X16_FRAME_SIZE);
+	_spi->endTransaction();
+
+	_engine->frameDone();
+	return true;
+}
+
+#if defined(ARDUINO_ARCH_MEGAAVR) && !defined(AD567X16_NO_SPI_ISR)
+static AD567X16SPIInterruptBackend *AD567X16_spi_backend = nullptr;
+
+void AD567X16SPIInterruptBackend::begin(AD567X16AsyncClass *engine, uint32_t clk)
+{
+	_engine = engine;
+	_settings = SPISettings(clk, MSBFIRST, SPI_MODE1);
+	AD567X16_spi_backend = this;
+	SPI.begin();
+}
+
+void AD567X16SPIInterruptBackend::beginFrames()
+{
+	// The bus is held for the whole run of frames, and the transfer complete interrupt only enabled meanwhile: the
+	// blocking SPI.transfer() waits for the same flag, which the interrupt vector clears
+	SPI.beginTransaction(_settings);
+	SPI0.INTFLAGS = SPI_IF_bm;
+	SPI0.INTCTRL = SPI_IE_bm;
+}
+
+void AD567X16SPIInterruptBackend::endFrames()
+{
+	SPI0.INTCTRL = 0;
+	_frame = nullptr;
+	SPI.endTransaction();
+}
+
+void AD567X16SPIInterruptBackend::startFrame(const byte *frame)
+{
+	_frame = frame;
+	_index = 0;
+	SPI0.DATA = frame[0];
+}
+
+void AD567X16SPIInterruptBackend::isr()
+{
+	if (!_frame)
+	{
+		// Transfer not started by this backend
+		SPI0.INTCTRL = 0;
+		return;
+	}
+
+	// Reading DATA clears the interrupt flag
+	(void)SPI0.DATA;
+
+	if (++_index < AD567X16_FRAME_SIZE)
+	{
+		SPI0.DATA = _frame[_index];
+	}
+	else
+	{
+		_engine->frameDone();
+	}
+}
+
+ISR(SPI0_INT_vect)
+{
+	if (AD567X16_spi_backend)
+	{
+		AD567X16_spi_backend->isr();
+	}
+}
+#endif
@@ -0,0 +1,175 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+AD567X16Bus.cpp - Coordinated updates of several Analog Devices AD567X 16-channel DACs sharing an SPI bus.
+*/
+
+#include <AD567X16Bus.h>
+
+AD567X16BusClass::AD567X16BusClass(SPIClass &spi)
+{
+	_spi = &spi;
+}
+
+AD567X16BusClass::AD567X16BusClass() : AD567X16BusClass(SPI) {}
+
+AD567X16Status AD567X16BusClass::addDevice(AD567X16Class &dac)
+{
+	// The devices must be on the SPI bus of the coordinator
+	if (_num_devices >= AD567X16_BUS_MAX_DEVICES || dac._spi != _spi)
+	{
+		return AD567X16_ERROR_DEVICE;
+	}
+
+	_devices[_num_devices++] = &dac;
+	return AD567X16_OK;
+}
+
+AD567X16Status AD567X16BusClass::stageChannel(uint8_t device, uint8_t channel, word value)
+{
+	if (device >= _num_devices)
+	{
+		return AD567X16_ERROR_DEVICE;
+	}
+
+	return _devices[device]->stageChannel(channel, value);
+}
+
+AD567X16Status AD567X16BusClass::stageChannel(uint8_t device, uint8_t channel, float value)
+{
+	if (device >= _num_devices)
+	{
+		return AD567X16_ERROR_DEVICE;
+	}
+
+	return _devices[device]->stageChannel(channel, value);
+}
+
+void AD567X16BusClass::commit(bool LDAC_commit)
+{
+	uint32_t start = micros();
+
+	// The transaction runs at the clock of the slowest device
+	uint32_t clock = 0xFFFFFFFF;
+	for (uint8_t i = 0; i < _num_devices; i++)
+	{
+		clock = min(clock, _devices[i]->_spiClk);
+	}
+
+	byte frames[AD567X16_STAGED_FRAMES * AD567X16_FRAME_SIZE];
+	uint32_t updated = 0; // Devices that received frames, one bit per device
+	_last_frames = 0;
+
+	// Staged values of every device, in the order the devices were added, in a single transaction.
+	// With LDAC_commit, they only reach the input registers, and the DAC registers are updated by the LDAC pulses.
+	_spi->beginTransaction(SPISettings(clock, MSBFIRST, SPI_MODE1));
+	for (uint8_t i = 0; i < _num_devices; i++)
+	{
+		AD567X16Class *dac = _devices[i];
+
+		// Staged values already in the input registers are elided, but the DAC registers still need the pulse
+		bool stale = false;
+		for (uint8_t channel = 0; channel < 16 && LDAC_commit && !stale; channel++)
+		{
+			stale = (dac->_dirty & (1 << channel)) &&
+					(!(dac->_DAC_known & (1 << channel)) || dac->_DAC_reg[channel] != dac->_staged[channel]);
+		}
+
+		int num_frames = dac->encodeStaged(frames, !LDAC_commit);
+		if (num_frames)
+		{
+			dac->sendFrames(frames, num_frames);
+			_last_frames += num_frames;
+		}
+		if (num_frames || stale)
+		{
+			updated |= (1UL << i);
+
+			// After a group commit of the device, its LDAC mask is restored before the pulse, as by updateDAC
+			if (LDAC_commit && dac->_group_mask)
+			{
+				AD567X16Class::encodeFrame(frames, AD567X16_CMD_LDAC_MASK_REG, 0x00, dac->_LDAC_user_mask);
+				dac->sendFrames(frames, 1);
+				_last_frames++;
+			}
+		}
+	}
+	_spi->endTransaction();
+
+	if (LDAC_commit && updated)
+	{
+		pulseLDAC(updated);
+	}
+
+	_last_time = micros() - start;
+}
+
+void AD567X16BusClass::pulseLDAC(uint32_t updated)
+{
+	// Pins to pulse: those of the updated devices, each pin once even when it is shared by several devices
+	uint32_t pulsed = 0;
+	for (uint8_t i = 0; i < _num_devices; i++)
+	{
+		if (!(updated & (1UL << i)))
+		{
+			continue;
+		}
+		bool shared = false;
+		for (uint8_t j = 0; j < i && !shared; j++)
+		{
+			shared = (pulsed & (1UL << j)) && _devices[j]->_LDAC_pin == _devices[i]->_LDAC_pin;
+		}
+		if (!shared)
+		{
+			pulsed |= (1UL << i);
+		}
+	}
+
+	// All the LDAC pins go low before any goes high, so the falling edges that load the DAC registers are only
+	// a few CPU cycles apart
+	for (uint8_t i = 0; i < _num_devices; i++)
+	{
+		if (pulsed & (1UL << i))
+		{
+			_devices[i]->_LDAC.low();
+		}
+	}
+	for (uint8_t i = 0; i < _num_devices; i++)
+	{
+		if (pulsed & (1UL << i))
+		{
+			_devices[i]->_LDAC.high();
+		}
+	}
+
+	// Every device on a pulsed pin has updated its DAC registers
+	for (uint8_t i = 0; i < _num_devices; i++)
+	{
+		for (uint8_t j = 0; j < _num_devices; j++)
+		{
+			if ((pulsed & (1UL << j)) && _devices[j]->_LDAC_pin == _devices[i]->_LDAC_pin)
+			{
+				_devices[i]->trackLDAC();
+				break;
+			}
+		}
+	}
+}
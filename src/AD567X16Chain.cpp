@@ -0,0 +1,188 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+AD567X16Chain.cpp - Daisy-chain support for the Analog Devices AD567X 16-channel DACs.
+*/
+
+#include <AD567X16Chain.h>
+
+AD567X16ChainClass::AD567X16ChainClass(SPIClass &spi, uint8_t num_devices, uint8_t resolution, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin)
+{
+	_spi = &spi;
+	_num_devices = constrain(num_devices, 1, AD567X16_CHAIN_MAX_DEVICES);
+	_shift = 16 - resolution;
+	_CS_pin = CS_pin;
+	_LDAC_pin = LDAC_pin;
+	_RESET_pin = RESET_pin;
+
+	_CS.begin(_CS_pin);
+	_LDAC.begin(_LDAC_pin);
+	_RESET.begin(_RESET_pin);
+
+	this->setSPIClock();
+
+	_CS.high();
+	_LDAC.high();
+	_RESET.high();
+
+	clearFrames();
+}
+
+AD567X16ChainClass::AD567X16ChainClass(uint8_t num_devices, uint8_t resolution, pin_size_t CS_pin, pin_size_t LDAC_pin, pin_size_t RESET_pin) : AD567X16ChainClass(SPI, num_devices, resolution, CS_pin, LDAC_pin, RESET_pin) {}
+
+void AD567X16ChainClass::begin()
+{
+	// Called from setup(), once the SPI bus is ready
+	resetRegisters();
+}
+
+void AD567X16ChainClass::setSPIClock(uint32_t clock)
+{
+	_spiClk = clock;
+}
+
+void AD567X16ChainClass::enableDaisyChain()
+{
+	_spi->beginTransaction(SPISettings(_spiClk, MSBFIRST, SPI_MODE1));
+
+	// Only the devices already in daisy-chain mode forward data to the next one,
+	// so the devices are enabled one by one, sending one more frame each time
+	for (uint8_t n = 1; n <= _num_devices; n++)
+	{
+		for (uint8_t i = 0; i < n; i++)
+		{
+			AD567X16Class::encodeFrame(_frames + i * AD567X16_FRAME_SIZE, AD567X16_CMD_DAISY_CHAIN, 0x00, AD567X16_DAISY_CHAIN_MESSAGE);
+		}
+		_CS.low();
+		_spi->transfer(_frames, n * AD567X16_FRAME_SIZE);
+		_CS.high();
+	}
+
+	_spi->endTransaction();
+	clearFrames();
+}
+
+void AD567X16ChainClass::resetRegisters(unsigned long delay_ms)
+{
+	// Pulse the shared RESET pin
+	_RESET.low();
+	if (delay_ms)
+	{
+		delay(delay_ms);
+	}
+	_RESET.high();
+
+	// The reset disables the daisy-chain mode
+	enableDaisyChain();
+}
+
+void AD567X16ChainClass::updateDAC(unsigned long delay_ms)
+{
+	// Pulse the shared LDAC pin
+	_LDAC.low();
+	if (delay_ms)
+	{
+		delay(delay_ms);
+	}
+	_LDAC.high();
+}
+
+AD567X16Status AD567X16ChainClass::setFrame(uint8_t device, byte command, byte address, word data)
+{
+	if (device >= _num_devices)
+	{
+		return reject(AD567X16_ERROR_DEVICE);
+	}
+
+	// The frame of the last device is shifted out first
+	AD567X16Class::encodeFrame(_frames + (_num_devices - 1 - device) * AD567X16_FRAME_SIZE, command, address, data);
+	return AD567X16_OK;
+}
+
+AD567X16Status AD567X16ChainClass::setChannel(uint8_t device, uint8_t channel, word value, bool DAC_update)
+{
+	if (channel > 15)
+	{
+		return reject(AD567X16_ERROR_CHANNEL);
+	}
+
+	return setFrame(device, DAC_update ? AD567X16_CMD_WRITE_DAC_REG : AD567X16_CMD_WRITE_INPUT_REG, channel, value << _shift);
+}
+
+void AD567X16ChainClass::transfer()
+{
+	_spi->beginTransaction(SPISettings(_spiClk, MSBFIRST, SPI_MODE1));
+	transferFrames();
+	_spi->endTransaction();
+}
+
+void AD567X16ChainClass::setChannels(const word *values, bool DAC_update, bool LDAC_commit)
+{
+	byte command = DAC_update ? AD567X16_CMD_WRITE_DAC_REG : AD567X16_CMD_WRITE_INPUT_REG;
+
+	// values[device * 16 + channel], one chain-wide transfer per channel
+	_spi->beginTransaction(SPISettings(_spiClk, MSBFIRST, SPI_MODE1));
+	for (uint8_t channel = 0; channel < 16; channel++)
+	{
+		for (uint8_t device = 0; device < _num_devices; device++)
+		{
+			setFrame(device, command, channel, values[device * 16 + channel] << _shift);
+		}
+		transferFrames();
+	}
+	_spi->endTransaction();
+
+	if (LDAC_commit && !DAC_update)
+	{
+		updateDAC();
+	}
+}
+
+AD567X16Status AD567X16ChainClass::reject(AD567X16Status status)
+{
+#if AD567X16_LOG_LEVEL >= AD567X16_LOG_ERROR
+	if (_log_output)
+	{
+		_log_output->print(F("Error: "));
+		_log_output->println(AD567X16StatusMessage(status));
+	}
+#endif
+	return status;
+}
+
+void AD567X16ChainClass::clearFrames()
+{
+	// Devices without a new frame receive a no-operation command
+	for (uint8_t i = 0; i < _num_devices; i++)
+	{
+		AD567X16Class::encodeFrame(_frames + i * AD567X16_FRAME_SIZE, AD567X16_CMD_NOP, 0x00, 0x0000);
+	}
+}
+
+void AD567X16ChainClass::transferFrames()
+{
+	// All the frames are shifted in a single CS-low window, and executed by every device when CS goes high
+	_CS.low();
+	_spi->transfer(_frames, _num_devices * AD567X16_FRAME_SIZE);
+	_CS.high();
+
+	clearFrames();
+}
@@ -0,0 +1,249 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+AD567X16DDS.cpp - Direct digital synthesis of periodic waveforms on the Analog Devices AD567X 16-channel DACs.
+*/
+
+#include <AD567X16DDS.h>
+
+// First quarter of a sine wave, sin(k * pi / 128) * 32767 for k = 0..64
+static const int16_t AD567X16_SINE_TABLE[65] PROGMEM = {
+	0, 804, 1608, 2410, 3212, 4011, 4808, 5602,
+	6393, 7179, 7962, 8739, 9512, 10278, 11039, 11793,
+	12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+	18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+	23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+	27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+	30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+	32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+	32767};
+
+AD567X16DDSClass::AD567X16DDSClass(AD567X16Class &dac)
+{
+	_dac = &dac;
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		_phase[i] = 0;
+		_frequency_mHz[i] = 0;
+		_increment[i] = 0;
+		_phase_offset[i] = 0;
+		_amplitude[i] = 0;
+		_offset[i] = 0;
+		_waveform[i] = AD567X16_SINE;
+	}
+}
+
+void AD567X16DDSClass::setSampleRate(uint32_t rate)
+{
+	if (!rate)
+	{
+		return;
+	}
+
+	_rate = rate;
+	_period = 1000000UL / rate;
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		updateIncrement(i);
+	}
+}
+
+void AD567X16DDSClass::setChannel(uint8_t channel, AD567X16Waveform waveform, uint32_t frequency_mHz, word amplitude, word offset)
+{
+	if (channel > 15)
+	{
+		return;
+	}
+
+	setWaveform(channel, waveform);
+	setFrequency(channel, frequency_mHz);
+	setAmplitude(channel, amplitude, offset);
+	enable(channel);
+}
+
+void AD567X16DDSClass::setFrequency(uint8_t channel, uint32_t frequency_mHz)
+{
+	if (channel > 15)
+	{
+		return;
+	}
+
+	_frequency_mHz[channel] = frequency_mHz;
+	updateIncrement(channel);
+}
+
+void AD567X16DDSClass::updateIncrement(uint8_t channel)
+{
+	// Phase increment = f / fs * 2^32, computed once here rather than on every tick
+	_increment[channel] = (uint32_t)(((uint64_t)_frequency_mHz[channel] << 32) / ((uint64_t)_rate * 1000));
+}
+
+void AD567X16DDSClass::setPhase(uint8_t channel, uint16_t phase)
+{
+	// 0x4000 is a quarter period, e.g. for quadrature outputs
+	if (channel <= 15)
+	{
+		_phase_offset[channel] = phase;
+	}
+}
+
+void AD567X16DDSClass::setAmplitude(uint8_t channel, word amplitude, word offset)
+{
+	if (channel > 15)
+	{
+		return;
+	}
+
+	// Given in the model resolution, like setChannel
+	_amplitude[channel] = amplitude << _dac->_shift;
+	_offset[channel] = offset << _dac->_shift;
+}
+
+void AD567X16DDSClass::setWaveform(uint8_t channel, AD567X16Waveform waveform)
+{
+	if (channel <= 15)
+	{
+		_waveform[channel] = waveform;
+	}
+}
+
+void AD567X16DDSClass::enable(uint8_t channel)
+{
+	if (channel > 15)
+	{
+		return;
+	}
+
+	// The ticks of poll() start with the first enabled channel
+	if (!_enabled)
+	{
+		_next_tick = micros();
+	}
+	_enabled |= (1 << channel);
+}
+
+void AD567X16DDSClass::disable(uint8_t channel)
+{
+	if (channel <= 15)
+	{
+		_enabled &= ~(1 << channel);
+	}
+}
+
+void AD567X16DDSClass::sync()
+{
+	// Restart all the accumulators together, the channels then only differ by their phase offsets
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		_phase[i] = 0;
+	}
+	_next_tick = micros();
+}
+
+int16_t AD567X16DDSClass::sample(AD567X16Waveform waveform, uint32_t phase)
+{
+	uint16_t p = phase >> 16;
+
+	switch (waveform)
+	{
+	case AD567X16_TRIANGLE:
+		return (p < 0x8000) ? (int16_t)(2 * p - 0x7FFF) : (int16_t)(0x7FFF - 2 * (p - 0x8000));
+	case AD567X16_SAW:
+	{
+		int16_t value = (int16_t)(p - 0x8000);
+		return (value == -0x8000) ? -0x7FFF : value;
+	}
+	case AD567X16_SQUARE:
+		return (p < 0x8000) ? 0x7FFF : -0x7FFF;
+	default:
+		break;
+	}
+
+	// Sine: 2 bits of quadrant, 6 bits of table index and 8 bits of linear interpolation
+	uint8_t quadrant = p >> 14;
+	uint16_t q = p & 0x3FFF;
+	if (quadrant & 0x01)
+	{
+		// Falling quarters read the table backwards
+		q = 0x4000 - q;
+	}
+	uint8_t index = q >> 8;
+	uint8_t fraction = q & 0xFF;
+
+	int16_t value = pgm_read_word(&AD567X16_SINE_TABLE[index]);
+	if (fraction)
+	{
+		int16_t next = pgm_read_word(&AD567X16_SINE_TABLE[index + 1]);
+		value += ((int32_t)(next - value) * fraction) >> 8;
+	}
+	return (quadrant & 0x02) ? -value : value;
+}
+
+void AD567X16DDSClass::tick()
+{
+	uint8_t channels[16];
+	word values[16];
+	uint8_t count = 0;
+
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		if (!(_enabled & (1 << i)))
+		{
+			continue;
+		}
+
+		int16_t s = sample(_waveform[i], _phase[i] + ((uint32_t)_phase_offset[i] << 16));
+		_phase[i] += _increment[i];
+
+		// Scale in 16-bit register units and clamp to the output range
+		int32_t code = (int32_t)_offset[i] + (((int32_t)s * _amplitude[i]) >> 15);
+		code = constrain(code, (int32_t)0, (int32_t)0xFFFF);
+
+		channels[count] = i;
+		values[count] = (word)code >> _dac->_shift;
+		count++;
+	}
+
+	if (!count)
+	{
+		return;
+	}
+
+	// Input registers in one transaction, then a single LDAC pulse commits all the channels
+	_dac->beginFrames();
+	_dac->writeChannels(channels, values, count, AD567X16_CMD_WRITE_INPUT_REG);
+	_dac->endFrames();
+	_dac->updateDAC();
+}
+
+bool AD567X16DDSClass::poll()
+{
+	unsigned long now = micros();
+	if ((long)(now - _next_tick) < 0)
+	{
+		return false;
+	}
+
+	// At most one tick of lag: the ticks missed while loop() was busy are dropped rather than caught up back to back
+	_next_tick = (now - _next_tick >= _period) ? now + _period : _next_tick + _period;
+	tick();
+	return true;
+}
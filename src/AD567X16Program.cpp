@@ -0,0 +1,199 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+AD567X16Program.cpp - Precompiled frame programs for the Analog Devices AD567X 16-channel DACs.
+*/
+
+#include <AD567X16Program.h>
+
+AD567X16ProgramClass::AD567X16ProgramClass(byte *buffer, size_t size)
+{
+	_buffer = buffer;
+	_size = size;
+}
+
+void AD567X16ProgramClass::clear()
+{
+	_length = 0;
+	_overflow = false;
+}
+
+bool AD567X16ProgramClass::append(byte command, byte address, word data)
+{
+	if (_length + AD567X16_FRAME_SIZE > _size)
+	{
+		_overflow = true;
+		return false;
+	}
+
+	AD567X16Class::encodeFrame(_buffer + _length, command, address, data);
+	_length += AD567X16_FRAME_SIZE;
+	return true;
+}
+
+bool AD567X16ProgramClass::append(const byte *frames, int num_frames)
+{
+	if (_length + (size_t)num_frames * AD567X16_FRAME_SIZE > _size)
+	{
+		_overflow = true;
+		return false;
+	}
+
+	memcpy(_buffer + _length, frames, num_frames * AD567X16_FRAME_SIZE);
+	_length += num_frames * AD567X16_FRAME_SIZE;
+	return true;
+}
+
+bool AD567X16ProgramClass::LDAC()
+{
+	return append(AD567X16_PROG_LDAC, 0x00, 0x0000);
+}
+
+bool AD567X16ProgramClass::delayMicros(uint32_t us)
+{
+	// Whole milliseconds first, then the remaining microseconds, each record holding up to 65535 units
+	uint32_t ms = us / 1000;
+	us %= 1000;
+	while (ms)
+	{
+		word chunk = min(ms, (uint32_t)0xFFFF);
+		if (!append(AD567X16_PROG_DELAY_MS, 0x00, chunk))
+		{
+			return false;
+		}
+		ms -= chunk;
+	}
+	return !us || append(AD567X16_PROG_DELAY_US, 0x00, us);
+}
+
+bool AD567X16ProgramClass::end()
+{
+	return append(AD567X16_PROG_END, 0x00, 0x0000);
+}
+
+AD567X16PlayerClass::AD567X16PlayerClass(AD567X16Class &dac)
+{
+	_dac = &dac;
+}
+
+uint32_t AD567X16PlayerClass::play(const byte *program, size_t length)
+{
+	uint32_t frames = 0;
+	byte record[AD567X16_FRAME_SIZE];
+
+	// The whole program runs within a single SPI transaction
+	_dac->beginFrames();
+	for (size_t i = 0; i + AD567X16_FRAME_SIZE <= length; i += AD567X16_FRAME_SIZE)
+	{
+		// Copied, as the SPI transfer overwrites the buffer
+		memcpy(record, program + i, AD567X16_FRAME_SIZE);
+		if (!execute(record, frames))
+		{
+			break;
+		}
+	}
+	_dac->endFrames();
+	return frames;
+}
+
+uint32_t AD567X16PlayerClass::play_P(const byte *program, size_t length)
+{
+	uint32_t frames = 0;
+	byte record[AD567X16_FRAME_SIZE];
+
+	_dac->beginFrames();
+	for (size_t i = 0; i + AD567X16_FRAME_SIZE <= length; i += AD567X16_FRAME_SIZE)
+	{
+		for (uint8_t j = 0; j < AD567X16_FRAME_SIZE; j++)
+		{
+			record[j] = pgm_read_byte(program + i + j);
+		}
+		if (!execute(record, frames))
+		{
+			break;
+		}
+	}
+	_dac->endFrames();
+	return frames;
+}
+
+uint32_t AD567X16PlayerClass::play(Stream &stream)
+{
+	uint32_t frames = 0;
+	byte record[AD567X16_FRAME_SIZE];
+
+	// One transaction per record, so that the stream can use the SPI bus in between (e.g. an SD card)
+	while (stream.readBytes(record, AD567X16_FRAME_SIZE) == AD567X16_FRAME_SIZE)
+	{
+		_dac->beginFrames();
+		bool more = execute(record, frames);
+		_dac->endFrames();
+		if (!more)
+		{
+			break;
+		}
+	}
+	return frames;
+}
+
+bool AD567X16PlayerClass::execute(byte *record, uint32_t &frames)
+{
+	word data = (record[1] << 8) | record[2];
+
+	switch (record[0] >> 4)
+	{
+	case AD567X16_PROG_LDAC:
+		// As updateDAC, but within the transaction of the program: the mask of a group commit is restored by a frame,
+		// then LDAC is pulsed directly
+		if (_dac->_group_mask)
+		{
+			if (_dac->_LDAC_mask_known && _dac->_LDAC_mask == _dac->_LDAC_user_mask)
+			{
+				_dac->_group_mask = false;
+			}
+			else
+			{
+				byte frame[AD567X16_FRAME_SIZE];
+				AD567X16Class::encodeFrame(frame, AD567X16_CMD_LDAC_MASK_REG, 0x00, _dac->_LDAC_user_mask);
+				_dac->trackFrame(frame);
+				_dac->transferFrames(frame, 1);
+				frames++;
+			}
+		}
+		_dac->pulseLDAC(0);
+		break;
+	case AD567X16_PROG_DELAY_US:
+		delayMicroseconds(data);
+		break;
+	case AD567X16_PROG_DELAY_MS:
+		delay(data);
+		break;
+	case AD567X16_PROG_END:
+		return false;
+	default:
+		// DAC frame, sent as stored. The shadow registers follow, so later writes are still elided correctly.
+		_dac->trackFrame(record);
+		_dac->transferFrames(record, 1);
+		frames++;
+		break;
+	}
+	return true;
+}
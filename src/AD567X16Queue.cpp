@@ -0,0 +1,208 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+AD567X16Queue.cpp - Lock-free command queue for the Analog Devices AD567X 16-channel DACs.
+*/
+
+#include <AD567X16Queue.h>
+
+AD567X16QueueClass::AD567X16QueueClass(AD567X16Class &dac)
+{
+	_dac = &dac;
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		_slots[i] = 0;
+		_sequence[i] = 0;
+	}
+}
+
+bool AD567X16QueueClass::setChannel(uint8_t channel, word value)
+{
+	if (channel > 15)
+	{
+		return false;
+	}
+
+	// Odd sequence number while the slot is being written, so the consumer can detect a torn read
+	uint8_t sequence = _sequence[channel];
+	storeRelease(&_sequence[channel], sequence + 1);
+	fence();
+	_slots[channel] = value;
+	storeRelease(&_sequence[channel], sequence + 2);
+
+	fetchOr(&_dirty, 1 << channel);
+	return true;
+}
+
+bool AD567X16QueueClass::push(byte command, byte address, word data)
+{
+	uint8_t head = _head;
+	if ((uint8_t)(head - loadAcquire(&_tail)) >= AD567X16_QUEUE_SIZE)
+	{
+		_dropped++;
+		return false;
+	}
+
+	AD567X16Class::encodeFrame(_frames[head & (AD567X16_QUEUE_SIZE - 1)], command, address, data);
+
+	// Publish the frame once it is complete
+	storeRelease(&_head, head + 1);
+	return true;
+}
+
+void AD567X16QueueClass::commit()
+{
+	// One LDAC pulse after the next drain, however many commits were requested
+	fetchOr(&_commit, 0x0001);
+}
+
+bool AD567X16QueueClass::pending() const
+{
+	return _dirty || _commit || loadAcquire(&_head) != _tail;
+}
+
+uint16_t AD567X16QueueClass::drain()
+{
+	if (!pending())
+	{
+		return 0;
+	}
+
+	uint32_t frames_sent = _dac->_frames_sent;
+	byte frames[AD567X16_BURST_FRAMES * AD567X16_FRAME_SIZE];
+	int count = 0;
+
+	_dac->beginFrames();
+
+	// Queued frames first, in order
+	uint8_t tail = _tail;
+	uint8_t head = loadAcquire(&_head);
+	while (tail != head)
+	{
+		memcpy(frames + count * AD567X16_FRAME_SIZE, _frames[tail & (AD567X16_QUEUE_SIZE - 1)], AD567X16_FRAME_SIZE);
+		tail++;
+		if (++count == AD567X16_BURST_FRAMES)
+		{
+			_dac->sendFrames(frames, count);
+			count = 0;
+		}
+	}
+	_dac->sendFrames(frames, count);
+
+	// The ring entries can be reused once copied
+	storeRelease(&_tail, tail);
+
+	// Then the latest value of every channel that changed
+	uint8_t channels[16];
+	word values[16];
+	count = 0;
+	word dirty = exchange(&_dirty, 0x0000);
+	for (uint8_t i = 0; dirty && i < 16; i++)
+	{
+		word mask = 1 << i;
+		if (!(dirty & mask))
+		{
+			continue;
+		}
+		dirty &= ~mask;
+
+		uint8_t sequence = loadAcquire(&_sequence[i]);
+		word value = _slots[i];
+		fence();
+		if ((sequence & 1) || sequence != loadAcquire(&_sequence[i]))
+		{
+			// Written while being read: left for the next drain, rather than waiting for the producer
+			fetchOr(&_dirty, mask);
+			continue;
+		}
+
+		channels[count] = i;
+		values[count] = value;
+		count++;
+	}
+	_dac->writeChannels(channels, values, count, AD567X16_CMD_WRITE_INPUT_REG);
+
+	_dac->endFrames();
+
+	if (exchange(&_commit, 0x0000))
+	{
+		_dac->updateDAC();
+	}
+
+	return _dac->_frames_sent - frames_sent;
+}
+
+uint8_t AD567X16QueueClass::loadAcquire(const volatile uint8_t *value)
+{
+#if defined(AD567X16_QUEUE_CRITICAL_SECTIONS)
+	// Single-byte accesses are atomic, and a single core only needs a compiler barrier
+	uint8_t result = *value;
+	__asm__ __volatile__("" ::: "memory");
+	return result;
+#else
+	return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+#endif
+}
+
+void AD567X16QueueClass::storeRelease(volatile uint8_t *value, uint8_t new_value)
+{
+#if defined(AD567X16_QUEUE_CRITICAL_SECTIONS)
+	__asm__ __volatile__("" ::: "memory");
+	*value = new_value;
+#else
+	__atomic_store_n(value, new_value, __ATOMIC_RELEASE);
+#endif
+}
+
+word AD567X16QueueClass::exchange(volatile word *value, word new_value)
+{
+#if defined(AD567X16_QUEUE_CRITICAL_SECTIONS)
+	uint8_t sreg = SREG;
+	cli();
+	word result = *value;
+	*value = new_value;
+	SREG = sreg;
+	return result;
+#else
+	return __atomic_exchange_n(value, new_value, __ATOMIC_ACQ_REL);
+#endif
+}
+
+void AD567X16QueueClass::fetchOr(volatile word *value, word bits)
+{
+#if defined(AD567X16_QUEUE_CRITICAL_SECTIONS)
+	uint8_t sreg = SREG;
+	cli();
+	*value |= bits;
+	SREG = sreg;
+#else
+	__atomic_fetch_or(value, bits, __ATOMIC_ACQ_REL);
+#endif
+}
+
+void AD567X16QueueClass::fence()
+{
+#if defined(AD567X16_QUEUE_CRITICAL_SECTIONS)
+	__asm__ __volatile__("" ::: "memory");
+#else
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+#endif
+}
@@ -0,0 +1,241 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+AD567X16Ramp.cpp - Slew-rate-limited ramps on the Analog Devices AD567X 16-channel DACs.
+*/
+
+#include <AD567X16Ramp.h>
+
+AD567X16RampClass::AD567X16RampClass(AD567X16Class &dac)
+{
+	_dac = &dac;
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		_slew[i] = 0;
+		_progress[i] = 0;
+		_step[i] = 0;
+		_start[i] = 0;
+		_target[i] = 0;
+		_position[i] = 0;
+		_profile[i] = AD567X16_LINEAR;
+	}
+}
+
+void AD567X16RampClass::setSampleRate(uint32_t rate)
+{
+	if (!rate)
+	{
+		return;
+	}
+
+	_rate = rate;
+	_period = 1000000UL / rate;
+
+	// Ramps in progress continue from where they are, at the new tick rate
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		if (_active & (1 << i))
+		{
+			startRamp(i);
+		}
+	}
+}
+
+AD567X16Status AD567X16RampClass::setRate(uint8_t channel, uint32_t rate)
+{
+	if (channel > 15)
+	{
+		return AD567X16_ERROR_CHANNEL;
+	}
+
+	_slew[channel] = rate;
+	if (_active & (1 << channel))
+	{
+		startRamp(channel);
+	}
+	return AD567X16_OK;
+}
+
+AD567X16Status AD567X16RampClass::setProfile(uint8_t channel, AD567X16RampProfile profile)
+{
+	if (channel > 15)
+	{
+		return AD567X16_ERROR_CHANNEL;
+	}
+
+	_profile[channel] = profile;
+	if (_active & (1 << channel))
+	{
+		startRamp(channel);
+	}
+	return AD567X16_OK;
+}
+
+AD567X16Status AD567X16RampClass::setTarget(uint8_t channel, word target)
+{
+	if (channel > 15)
+	{
+		return AD567X16_ERROR_CHANNEL;
+	}
+
+	word mask = 1 << channel;
+	if (!(_known & mask))
+	{
+		// First ramp of the channel: start from the input register if the driver knows it, else from zero scale
+		_position[channel] = (_dac->_input_known & mask) ? _dac->_input_reg[channel] : 0x0000;
+		_known |= mask;
+	}
+
+	// First ramp after an idle period: poll() counts the ticks from now, not from the last ramp (or from boot)
+	if (!_active)
+	{
+		_next_tick = micros();
+	}
+
+	_target[channel] = target << _dac->_shift;
+	_completed &= ~mask;
+	_active |= mask;
+	startRamp(channel);
+	return AD567X16_OK;
+}
+
+void AD567X16RampClass::stop(uint8_t channel)
+{
+	// The output stays where the ramp was
+	_active &= ~(1 << (channel & 0x0F));
+}
+
+void AD567X16RampClass::startRamp(uint8_t channel)
+{
+	// A new ramp segment from the current output to the target, computed once here rather than on every tick
+	_start[channel] = _position[channel];
+	_progress[channel] = 0;
+
+	uint32_t distance = (_target[channel] > _start[channel]) ? _target[channel] - _start[channel] : _start[channel] - _target[channel];
+	uint32_t slew = min(_slew[channel], (uint32_t)0x0FFFFFFF) << _dac->_shift; // Register units per second
+
+	if (!slew || slew >= (uint64_t)distance * _rate)
+	{
+		// No limit, or less than one tick away: the target is reached at the next tick
+		_step[channel] = 0xFFFFFFFF;
+		return;
+	}
+
+	// Progress per tick = slew / (distance * rate), in Q32, rounded up so the ramp never ends late
+	uint64_t ticks = (uint64_t)distance * _rate;
+	uint64_t step = (((uint64_t)slew << 32) + ticks - 1) / ticks;
+	if (_profile[channel] == AD567X16_SCURVE)
+	{
+		// The smoothstep peaks at 1.5 times the average rate
+		step = step * 2 / 3;
+	}
+	_step[channel] = step ? (uint32_t)step : 1;
+}
+
+void AD567X16RampClass::tick()
+{
+	if (!_active)
+	{
+		return;
+	}
+
+	uint8_t channels[16];
+	word values[16];
+	uint8_t count = 0;
+	uint8_t shift = _dac->_shift;
+
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		word mask = 1 << i;
+		if (!(_active & mask))
+		{
+			continue;
+		}
+
+		word position;
+		if (_step[i] >= 0xFFFFFFFF - _progress[i])
+		{
+			// The target is reached
+			position = _target[i];
+			_active &= ~mask;
+			_completed |= mask;
+		}
+		else
+		{
+			_progress[i] += _step[i];
+
+			// Fraction of the distance covered, in Q16
+			uint32_t p = _progress[i] >> 16;
+			uint32_t f = p;
+			if (_profile[i] == AD567X16_SCURVE)
+			{
+				// f = 3p^2 - 2p^3, rearranged to stay within 32 bits
+				uint32_t p2 = (p * p) >> 16;
+				f = (p2 * ((196608UL - 2 * p) >> 2)) >> 14;
+			}
+
+			// Distance covered, rounded to the nearest register unit
+			if (_target[i] >= _start[i])
+			{
+				position = _start[i] + (word)(((uint32_t)(_target[i] - _start[i]) * f + 0x8000) >> 16);
+			}
+			else
+			{
+				position = _start[i] - (word)(((uint32_t)(_start[i] - _target[i]) * f + 0x8000) >> 16);
+			}
+		}
+
+		// Only the channels whose output code changes are written
+		if ((position >> shift) != (_position[i] >> shift))
+		{
+			channels[count] = i;
+			values[count] = position >> shift;
+			count++;
+		}
+		_position[i] = position;
+	}
+
+	if (!count)
+	{
+		return;
+	}
+
+	// Input registers in one transaction, then a single LDAC pulse commits all the channels
+	_dac->beginFrames();
+	_dac->writeChannels(channels, values, count, AD567X16_CMD_WRITE_INPUT_REG);
+	_dac->endFrames();
+	_dac->updateDAC();
+}
+
+bool AD567X16RampClass::poll()
+{
+	unsigned long now = micros();
+	if ((long)(now - _next_tick) < 0)
+	{
+		return false;
+	}
+
+	// At most one tick of lag: the ticks missed while loop() was busy are dropped rather than caught up back to back,
+	// which would step the outputs faster than their rate
+	_next_tick = (now - _next_tick >= _period) ? now + _period : _next_tick + _period;
+	tick();
+	return true;
+}
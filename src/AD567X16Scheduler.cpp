@@ -0,0 +1,286 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+AD567X16Scheduler.cpp - Timestamped setpoints on the Analog Devices AD567X 16-channel DACs.
+*/
+
+#include <AD567X16Scheduler.h>
+
+AD567X16SchedulerClass::AD567X16SchedulerClass(AD567X16Class &dac)
+{
+	_dac = &dac;
+	resetStats();
+}
+
+AD567X16Status AD567X16SchedulerClass::schedule(uint32_t time, uint8_t channel, word value)
+{
+	if (channel > 15)
+	{
+		return AD567X16_ERROR_CHANNEL;
+	}
+	if (!disarm(time, 1))
+	{
+		return AD567X16_ERROR_FULL;
+	}
+	return insert(time, channel, value);
+}
+
+AD567X16Status AD567X16SchedulerClass::schedule(uint32_t time, uint8_t channel, float value)
+{
+	AD567X16Status status = _dac->checkVoltage(value);
+	if (status != AD567X16_OK)
+	{
+		return status;
+	}
+	return schedule(time, channel, _dac->voltageToCode(value));
+}
+
+AD567X16Status AD567X16SchedulerClass::schedule(uint32_t time, const uint8_t *channels, const word *values, int num_channels)
+{
+	// All the setpoints are scheduled, or none
+	AD567X16Status status = _dac->checkChannels(channels, num_channels);
+	if (status != AD567X16_OK)
+	{
+		return status;
+	}
+	if (!disarm(time, num_channels) || num_channels > AD567X16_SCHEDULER_EVENTS - _count)
+	{
+		return AD567X16_ERROR_FULL;
+	}
+
+	for (int i = 0; i < num_channels; i++)
+	{
+		insert(time, channels[i], values[i]);
+	}
+	return AD567X16_OK;
+}
+
+void AD567X16SchedulerClass::clear()
+{
+	// The setpoints already preloaded stay in the input registers, but are not committed
+	_count = 0;
+	_armed = false;
+	_fired = false;
+}
+
+bool AD567X16SchedulerClass::poll()
+{
+	// Bookkeeping of a commit fired from an interrupt
+	if (_fired)
+	{
+		finish();
+	}
+
+	if (!_armed)
+	{
+		if (!_count)
+		{
+			return false;
+		}
+		arm();
+	}
+
+	// Wait for a close deadline rather than committing it late at the next call
+	int32_t remaining = (int32_t)(_deadline - micros());
+	if (remaining > AD567X16_SCHEDULER_SPIN_US)
+	{
+		return false;
+	}
+	while (remaining > 0)
+	{
+		delayMicroseconds(remaining);
+		remaining = (int32_t)(_deadline - micros());
+	}
+
+	commit();
+	finish();
+	return true;
+}
+
+void AD567X16SchedulerClass::commit()
+{
+	// Only a pin pulse, so that it can be called from a timer interrupt at the deadline
+	if (!_armed || _fired)
+	{
+		return;
+	}
+	_dac->_LDAC.low();
+	_dac->_LDAC.high();
+	_fired_at = micros();
+	_fired = true;
+}
+
+void AD567X16SchedulerClass::resetStats()
+{
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+AD567X16Status AD567X16SchedulerClass::insert(uint32_t time, uint8_t channel, word value)
+{
+	// A later setpoint for the same channel and deadline replaces the earlier one
+	for (uint8_t i = 0; i < _count; i++)
+	{
+		if (_events[i].time == time && _events[i].channel == channel)
+		{
+			_events[i].value = value;
+			return AD567X16_OK;
+		}
+	}
+
+	if (_count == AD567X16_SCHEDULER_EVENTS)
+	{
+		return AD567X16_ERROR_FULL;
+	}
+
+	// Sift up from the new leaf
+	uint8_t i = _count++;
+	while (i && before(time, _events[(i - 1) / 2].time))
+	{
+		_events[i] = _events[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+	_events[i].time = time;
+	_events[i].value = value;
+	_events[i].channel = channel;
+	return AD567X16_OK;
+}
+
+void AD567X16SchedulerClass::remove()
+{
+	// Move the last leaf to the root, then sift it down
+	Event last = _events[--_count];
+	uint8_t i = 0;
+	while (true)
+	{
+		uint8_t child = 2 * i + 1;
+		if (child >= _count)
+		{
+			break;
+		}
+		if (child + 1 < _count && before(_events[child + 1].time, _events[child].time))
+		{
+			child++;
+		}
+		if (!before(_events[child].time, last.time))
+		{
+			break;
+		}
+		_events[i] = _events[child];
+		i = child;
+	}
+	_events[i] = last;
+}
+
+bool AD567X16SchedulerClass::disarm(uint32_t time, int num_channels)
+{
+	noInterrupts();
+	if (!_armed || _fired || before(_deadline, time))
+	{
+		interrupts();
+		return true;
+	}
+
+	// A deadline no later than the preloaded one: its setpoints go back to the heap, from the input registers, and
+	// the next arm() preloads the deadlines in order again
+	int preloaded = 0;
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		preloaded += (_group >> i) & 1;
+	}
+	if (preloaded + num_channels > AD567X16_SCHEDULER_EVENTS - _count)
+	{
+		interrupts();
+		return false;
+	}
+	_armed = false;
+	interrupts();
+
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		if (_group & (1 << i))
+		{
+			insert(_deadline, i, _dac->_input_reg[i] >> _dac->_shift);
+		}
+	}
+	return true;
+}
+
+void AD567X16SchedulerClass::arm()
+{
+	// Every setpoint of the next deadline
+	_deadline = _events[0].time;
+	uint8_t channels[16];
+	word values[16];
+	word group = 0x0000;
+	int count = 0;
+	while (_count && _events[0].time == _deadline)
+	{
+		channels[count] = _events[0].channel;
+		values[count] = _events[0].value;
+		group |= (1 << _events[0].channel);
+		count++;
+		remove();
+	}
+
+	// Preload the input registers, and mask the other channels so that the LDAC pulse only commits these ones
+	_group = group;
+	_dac->beginFrames();
+	_dac->writeChannels(channels, values, count, AD567X16_CMD_WRITE_INPUT_REG);
+	word mask = ~group;
+	if (!_dac->_LDAC_mask_known || _dac->_LDAC_mask != mask)
+	{
+		byte frame[AD567X16_FRAME_SIZE];
+		AD567X16Class::encodeFrame(frame, AD567X16_CMD_LDAC_MASK_REG, 0x00, mask);
+		_dac->sendFrames(frame, 1);
+	}
+	else
+	{
+		_dac->_frames_elided++;
+	}
+	_dac->endFrames();
+
+	// Like a group commit, the mask is replaced by the application one on the next updateDAC
+	_dac->_group_mask = true;
+
+	if (!before(micros(), _deadline))
+	{
+		_stats.late++;
+	}
+	_fired = false;
+	_armed = true;
+}
+
+void AD567X16SchedulerClass::finish()
+{
+	// Shadow update and statistics of the commit, outside of the interrupt
+	_dac->trackLDAC();
+
+	uint32_t lateness = before(_deadline, _fired_at) ? _fired_at - _deadline : 0;
+	_stats.commits++;
+	_stats.total_lateness += lateness;
+	if (lateness > _stats.max_lateness)
+	{
+		_stats.max_lateness = lateness;
+	}
+
+	_armed = false;
+	_fired = false;
+}
@@ -0,0 +1,308 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+AD567X16Stream.cpp - Timer-driven waveform streaming for the Analog Devices AD567X 16-channel DACs.
+*/
+
+#include <AD567X16Stream.h>
+
+#if defined(ARDUINO_ARCH_MEGAAVR) && !defined(AD567X16_NO_STREAM_TIMER)
+#ifndef AD567X16_STREAM_TCB
+#define AD567X16_STREAM_TCB TCB2 // 16-bit timer used by beginTimer()
+#endif
+#ifndef AD567X16_STREAM_TCB_vect
+#define AD567X16_STREAM_TCB_vect TCB2_INT_vect
+#endif
+
+static AD567X16StreamClass *AD567X16_stream_timer = nullptr;
+#endif
+
+AD567X16StreamClass::AD567X16StreamClass(AD567X16Class &dac)
+{
+	_dac = &dac;
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		_rings[i].buffer = nullptr;
+		_rings[i].mask = 0;
+		_rings[i].head = 0;
+		_rings[i].tail = 0;
+	}
+}
+
+bool AD567X16StreamClass::attach(uint8_t channel, word *buffer, uint16_t size)
+{
+	// The size must be a power of two, for cheap index wrapping in tick()
+	if (channel > 15 || size < 2 || (size & (size - 1)))
+	{
+		return false;
+	}
+
+	noInterrupts();
+	_rings[channel].buffer = buffer;
+	_rings[channel].mask = size - 1;
+	_rings[channel].head = 0;
+	_rings[channel].tail = 0;
+	_active |= (1 << channel);
+	interrupts();
+	return true;
+}
+
+void AD567X16StreamClass::detach(uint8_t channel)
+{
+	if (channel > 15)
+	{
+		return;
+	}
+
+	noInterrupts();
+	_active &= ~(1 << channel);
+	interrupts();
+}
+
+void AD567X16StreamClass::setSampleRate(uint32_t rate)
+{
+	if (rate)
+	{
+		_rate = rate;
+		_period = 1000000UL / rate;
+	}
+}
+
+void AD567X16StreamClass::onRefill(AD567X16RefillCallback callback, void *context, uint16_t threshold)
+{
+	_refill = callback;
+	_context = context;
+	_threshold = threshold ? threshold : 1;
+}
+
+uint16_t AD567X16StreamClass::available(uint8_t channel) const
+{
+	if (channel > 15)
+	{
+		return 0;
+	}
+
+	noInterrupts();
+	uint16_t count = (_rings[channel].head - _rings[channel].tail) & _rings[channel].mask;
+	interrupts();
+	return count;
+}
+
+uint16_t AD567X16StreamClass::space(uint8_t channel) const
+{
+	if (channel > 15 || !_rings[channel].buffer)
+	{
+		return 0;
+	}
+
+	// One slot is kept free to tell a full ring from an empty one
+	return _rings[channel].mask - available(channel);
+}
+
+uint16_t AD567X16StreamClass::write(uint8_t channel, const word *samples, uint16_t count)
+{
+	if (channel > 15)
+	{
+		return 0;
+	}
+
+	uint16_t room = space(channel);
+	if (count > room)
+	{
+		// The samples that do not fit are dropped
+		_overruns++;
+		count = room;
+	}
+
+	AD567X16Ring &ring = _rings[channel];
+	uint16_t head = ring.head;
+	for (uint16_t i = 0; i < count; i++)
+	{
+		ring.buffer[head] = samples[i];
+		head = (head + 1) & ring.mask;
+	}
+
+	// Publish the samples to tick()
+	noInterrupts();
+	ring.head = head;
+	interrupts();
+	return count;
+}
+
+void AD567X16StreamClass::start()
+{
+	_next_tick = micros();
+	_running = true;
+}
+
+void AD567X16StreamClass::stop()
+{
+	_running = false;
+}
+
+void AD567X16StreamClass::tick()
+{
+	if (!_running)
+	{
+		return;
+	}
+
+	uint8_t channels[16];
+	word values[16];
+	uint8_t count = 0;
+
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		if (!(_active & (1 << i)))
+		{
+			continue;
+		}
+
+		AD567X16Ring &ring = _rings[i];
+		if (ring.tail == ring.head)
+		{
+			// No sample available, the output keeps its previous value
+			_underruns++;
+			continue;
+		}
+		channels[count] = i;
+		values[count] = ring.buffer[ring.tail];
+		count++;
+		ring.tail = (ring.tail + 1) & ring.mask;
+	}
+
+	if (!count)
+	{
+		return;
+	}
+
+	// Write the input registers in a single transaction, then update all the outputs together
+	_dac->beginFrames();
+	_dac->writeChannels(channels, values, count, AD567X16_CMD_WRITE_INPUT_REG);
+	_dac->endFrames();
+	_dac->updateDAC();
+}
+
+bool AD567X16StreamClass::poll()
+{
+	if (!_running)
+	{
+		return false;
+	}
+
+	// Ticks are scheduled from the previous deadline, so that loop jitter does not accumulate, with at most one tick of
+	// lag: the ticks missed while loop() was busy are dropped rather than caught up back to back, like the ramps
+	bool ticked = false;
+	unsigned long now = micros();
+	if ((long)(now - _next_tick) >= 0)
+	{
+		_next_tick = (now - _next_tick >= _period) ? now + _period : _next_tick + _period;
+		tick();
+		ticked = true;
+	}
+	service();
+	return ticked;
+}
+
+void AD567X16StreamClass::service()
+{
+	if (!_refill)
+	{
+		return;
+	}
+
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		if (!(_active & (1 << i)))
+		{
+			continue;
+		}
+
+		uint16_t room = space(i);
+		if (room >= _threshold)
+		{
+			_refill(i, room, _context);
+		}
+	}
+}
+
+void AD567X16StreamClass::clearCounters()
+{
+	noInterrupts();
+	_underruns = 0;
+	_overruns = 0;
+	interrupts();
+}
+
+#if defined(ARDUINO_ARCH_MEGAAVR) && !defined(AD567X16_NO_STREAM_TIMER)
+bool AD567X16StreamClass::beginTimer()
+{
+	// Periodic interrupt mode, clocked from CLK_PER / 2, or from the clock of TCA0 for the periods longer than
+	// 65536 of its cycles (8.192 ms at 16 MHz). The period is derived from the rate, not from the whole microseconds
+	// of _period, e.g. for 44.1 kHz.
+	uint32_t top = (F_CPU / 2 + _rate / 2) / _rate - 1;
+	uint8_t clksel = TCB_CLKSEL_CLKDIV2_gc;
+	if (top > 0xFFFF)
+	{
+		static const uint16_t TCA_dividers[8] = {1, 2, 4, 8, 16, 64, 256, 1024};
+		if (!(TCA0.SINGLE.CTRLA & TCA_SINGLE_ENABLE_bm))
+		{
+			return false;
+		}
+		uint32_t clock = F_CPU / TCA_dividers[(TCA0.SINGLE.CTRLA & TCA_SINGLE_CLKSEL_gm) >> 1];
+		top = (clock + _rate / 2) / _rate - 1;
+		clksel = TCB_CLKSEL_CLKTCA_gc;
+		if (top > 0xFFFF)
+		{
+			return false;
+		}
+	}
+
+	AD567X16_stream_timer = this;
+
+	AD567X16_STREAM_TCB.CTRLA = 0;
+	AD567X16_STREAM_TCB.CTRLB = TCB_CNTMODE_INT_gc;
+	AD567X16_STREAM_TCB.CCMP = top;
+	AD567X16_STREAM_TCB.CNT = 0;
+	AD567X16_STREAM_TCB.INTFLAGS = TCB_CAPT_bm;
+	AD567X16_STREAM_TCB.INTCTRL = TCB_CAPT_bm;
+	AD567X16_STREAM_TCB.CTRLA = clksel | TCB_ENABLE_bm;
+
+	start();
+	return true;
+}
+
+void AD567X16StreamClass::endTimer()
+{
+	AD567X16_STREAM_TCB.INTCTRL = 0;
+	AD567X16_STREAM_TCB.CTRLA = 0;
+	stop();
+}
+
+ISR(AD567X16_STREAM_TCB_vect)
+{
+	AD567X16_STREAM_TCB.INTFLAGS = TCB_CAPT_bm;
+	if (AD567X16_stream_timer)
+	{
+		AD567X16_stream_timer->tick();
+	}
+}
+#endif
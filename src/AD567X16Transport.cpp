@@ -0,0 +1,161 @@
+/*
+Copyright (c) 2025 Loris Mendolia
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+AD567X16Transport.cpp - Frame transports for the Analog Devices AD567X 16-channel DACs.
+*/
+
+#include <AD567X16.h>
+
+void AD567X16SPITransport::begin(uint32_t clk)
+{
+	_spi->beginTransaction(SPISettings(clk, MSBFIRST, SPI_MODE1));
+}
+
+void AD567X16SPITransport::transferFrames(byte *frames, int num_frames, const AD567X16Pin &CS)
+{
+	// The DAC executes a frame when SYNC (CS) goes high, so CS is toggled once per frame
+	for (int i = 0; i < num_frames; i++)
+	{
+		byte *frame = frames + i * AD567X16_FRAME_SIZE;
+		CS.low();
+#if defined(ARDUINO_ARCH_ESP32)
+		// One 24-bit transfer instead of three 8-bit ones
+		uint32_t received;
+		_spi->transferBits(((uint32_t)frame[0] << 16) | ((uint32_t)frame[1] << 8) | frame[2], &received, 24);
+		frame[0] = received >> 16;
+		frame[1] = received >> 8;
+		frame[2] = received;
+#else
+		_spi->transfer(frame, AD567X16_FRAME_SIZE);
+#endif
+		CS.high();
+	}
+}
+
+void AD567X16SPITransport::end()
+{
+	_spi->endTransaction();
+}
+
+AD567X16BitBangTransport::AD567X16BitBangTransport(pin_size_t SCLK_pin, pin_size_t MOSI_pin, pin_size_t MISO_pin)
+{
+	_SCLK.begin(SCLK_pin);
+	_MOSI.begin(MOSI_pin);
+	_read = (MISO_pin != AD567X16_NO_PIN);
+	if (_read)
+	{
+		_MISO.begin(MISO_pin);
+	}
+	_SCLK.low();
+}
+
+void AD567X16BitBangTransport::begin(uint32_t clk)
+{
+	// Above 500 kHz, the port writes are the only limit
+	_half_period_us = (clk && clk < 500000UL) ? (500000UL + clk - 1) / clk : 0;
+
+	// SPI mode 1 idles with SCLK low
+	_SCLK.low();
+}
+
+void AD567X16BitBangTransport::transferFrames(byte *frames, int num_frames, const AD567X16Pin &CS)
+{
+	for (int i = 0; i < num_frames * AD567X16_FRAME_SIZE; i += AD567X16_FRAME_SIZE)
+	{
+		CS.low();
+		frames[i] = transferByte(frames[i]);
+		frames[i + 1] = transferByte(frames[i + 1]);
+		frames[i + 2] = transferByte(frames[i + 2]);
+		CS.high();
+	}
+}
+
+// SPI mode 1: the data changes on the rising edge of SCLK and is sampled on the falling edge
+#define AD567X16_BITBANG_BIT(mask)          \
+	_SCLK.high();                           \
+	if (data & (mask))                      \
+	{                                       \
+		_MOSI.high();                       \
+	}                                       \
+	else                                    \
+	{                                       \
+		_MOSI.low();                        \
+	}                                       \
+	if (_half_period_us)                    \
+	{                                       \
+		delayMicroseconds(_half_period_us); \
+	}                                       \
+	_SCLK.low();                            \
+	if (_read && _MISO.read())              \
+	{                                       \
+		received |= (mask);                 \
+	}                                       \
+	if (_half_period_us)                    \
+	{                                       \
+		delayMicroseconds(_half_period_us); \
+	}
+
+byte AD567X16BitBangTransport::transferByte(byte data)
+{
+	byte received = 0;
+
+	// Unrolled, MSB first
+	AD567X16_BITBANG_BIT(0x80)
+	AD567X16_BITBANG_BIT(0x40)
+	AD567X16_BITBANG_BIT(0x20)
+	AD567X16_BITBANG_BIT(0x10)
+	AD567X16_BITBANG_BIT(0x08)
+	AD567X16_BITBANG_BIT(0x04)
+	AD567X16_BITBANG_BIT(0x02)
+	AD567X16_BITBANG_BIT(0x01)
+	return received;
+}
+
+#undef AD567X16_BITBANG_BIT
+
+void AD567X16MockTransport::begin(uint32_t clk)
+{
+	_clk = clk;
+	_transactions++;
+}
+
+void AD567X16MockTransport::transferFrames(byte *frames, int num_frames, const AD567X16Pin &CS)
+{
+	(void)CS;
+	size_t size = num_frames * AD567X16_FRAME_SIZE;
+	if (_length + size > _size)
+	{
+		_overflow = true;
+		size = _size - _length;
+	}
+	memcpy(_buffer + _length, frames, size);
+	_length += size;
+
+	// Nothing received
+	memset(frames, 0, num_frames * AD567X16_FRAME_SIZE);
+}
+
+void AD567X16MockTransport::clear()
+{
+	_length = 0;
+	_overflow = false;
+	_transactions = 0;
+}